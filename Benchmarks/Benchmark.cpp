@@ -0,0 +1,510 @@
+#include "Ptr.h"
+#include "PtrVector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/////////ALLOCATION COUNTING
+//Every allocation in the process goes through these so each case can report allocations per operation
+static std::atomic<std::size_t> allocationCount{ 0 };
+
+static void* countedAllocate(std::size_t size, std::size_t alignment){
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* memory = nullptr;
+	if(alignment <= alignof(std::max_align_t)){
+		memory = std::malloc(size ? size : 1);
+	} else{
+#if defined(_MSC_VER)
+		memory = _aligned_malloc(size ? size : 1, alignment);
+#else
+		memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+	}
+
+	if(!memory){
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+static void countedFree(void* memory, std::size_t alignment){
+#if defined(_MSC_VER)
+	if(alignment > alignof(std::max_align_t)){
+		_aligned_free(memory);
+		return;
+	}
+#else
+	(void)alignment;
+#endif
+	std::free(memory);
+}
+
+void* operator new(std::size_t size){
+	return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size){
+	return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment){
+	return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment){
+	return countedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept{
+	countedFree(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory) noexcept{
+	countedFree(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::size_t) noexcept{
+	countedFree(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory, std::size_t) noexcept{
+	countedFree(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept{
+	countedFree(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept{
+	countedFree(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept{
+	countedFree(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept{
+	countedFree(memory, static_cast<std::size_t>(alignment));
+}
+
+/////////MEASUREMENT
+struct Result{
+	double nsPerOp = 0.0;
+	double allocsPerOp = 0.0;
+	bool ran = false;
+};
+
+//Stops the compiler from optimising away work whose result is never read
+template<typename Type>
+inline void doNotOptimise(const Type& value){
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static const void* volatile sink;
+	sink = &value;
+#endif
+}
+
+template<typename FunctionType>
+Result measure(std::size_t operations, FunctionType&& function){
+	const std::size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+	const auto start = std::chrono::steady_clock::now();
+
+	function();
+
+	const auto end = std::chrono::steady_clock::now();
+	const std::size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+	Result result;
+	result.nsPerOp = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(operations);
+	result.allocsPerOp = static_cast<double>(allocations) / static_cast<double>(operations);
+	result.ran = true;
+	return result;
+}
+
+/////////TEST TYPES
+struct Base{
+	int value = 0;
+
+	Base() = default;
+	explicit Base(int inValue)
+		: value(inValue){
+	}
+	virtual ~Base() = default;
+};
+
+struct Derived : public Base{
+	int extra = 0;
+
+	using Base::Base;
+};
+
+/////////POLICIES
+//Each policy wraps one pointer family so every case is written once and run against all of them
+template<typename CounterType>
+struct AgmPolicy{
+	template<typename Type> using Shared = agm::SharedPtr<Type, agm::DefaultDeleter, CounterType>;
+	template<typename Type> using Weak = agm::WeakPtr<Type, agm::DefaultDeleter, CounterType>;
+	template<typename Type> using Unique = agm::UniquePtr<Type>;
+	template<typename Type> using Vector = agm::PtrVector<Shared<Type>>;
+
+	static constexpr bool threadSafe = !std::is_same<CounterType, agm::Counter>::value;
+
+	template<typename Type, typename... ArgTypes>
+	static Shared<Type> makeShared(ArgTypes&&... args){
+		return agm::makeShared<Type, CounterType>(std::forward<ArgTypes>(args)...);
+	}
+
+	template<typename Type, typename... ArgTypes>
+	static Unique<Type> makeUnique(ArgTypes&&... args){
+		return agm::makeUnique(new Type(std::forward<ArgTypes>(args)...));
+	}
+
+	template<typename Type>
+	static Shared<Type> pin(Weak<Type>& ptr){
+		return ptr.pin();
+	}
+
+	template<typename Type>
+	static void pushBack(Vector<Type>& vector, const Shared<Type>& ptr){
+		vector.pushBack(ptr);
+	}
+
+	template<typename ReturnType, typename CurrentType>
+	static Shared<ReturnType> staticCast(const Shared<CurrentType>& ptr){
+		return agm::staticCast<ReturnType>(ptr);
+	}
+
+	template<typename ReturnType, typename CurrentType>
+	static Shared<ReturnType> dynamicCast(const Shared<CurrentType>& ptr){
+		return agm::dynamicCast<ReturnType>(ptr);
+	}
+
+	template<typename ReturnType, typename CurrentType>
+	static Shared<ReturnType> staticCast(Shared<CurrentType>&& ptr){
+		return agm::staticCast<ReturnType>(std::move(ptr));
+	}
+};
+
+struct StdPolicy{
+	template<typename Type> using Shared = std::shared_ptr<Type>;
+	template<typename Type> using Weak = std::weak_ptr<Type>;
+	template<typename Type> using Unique = std::unique_ptr<Type>;
+	template<typename Type> using Vector = std::vector<Shared<Type>>;
+
+	static constexpr bool threadSafe = true;
+
+	template<typename Type, typename... ArgTypes>
+	static Shared<Type> makeShared(ArgTypes&&... args){
+		return std::make_shared<Type>(std::forward<ArgTypes>(args)...);
+	}
+
+	template<typename Type, typename... ArgTypes>
+	static Unique<Type> makeUnique(ArgTypes&&... args){
+		return std::make_unique<Type>(std::forward<ArgTypes>(args)...);
+	}
+
+	template<typename Type>
+	static Shared<Type> pin(Weak<Type>& ptr){
+		return ptr.lock();
+	}
+
+	template<typename Type>
+	static void pushBack(Vector<Type>& vector, const Shared<Type>& ptr){
+		vector.push_back(ptr);
+	}
+
+	template<typename ReturnType, typename CurrentType>
+	static Shared<ReturnType> staticCast(const Shared<CurrentType>& ptr){
+		return std::static_pointer_cast<ReturnType>(ptr);
+	}
+
+	template<typename ReturnType, typename CurrentType>
+	static Shared<ReturnType> dynamicCast(const Shared<CurrentType>& ptr){
+		return std::dynamic_pointer_cast<ReturnType>(ptr);
+	}
+
+	//The rvalue std::static_pointer_cast only exists from C++20
+	template<typename ReturnType, typename CurrentType>
+	static Shared<ReturnType> staticCast(Shared<CurrentType>&& ptr){
+#if __cplusplus >= 202002L
+		return std::static_pointer_cast<ReturnType>(std::move(ptr));
+#else
+		return std::static_pointer_cast<ReturnType>(ptr);
+#endif
+	}
+};
+
+/////////CASES
+struct Settings{
+	std::size_t iterations = 1000000;
+	std::size_t containerSize = 100000;
+	unsigned threads = 4;
+};
+
+template<typename Policy>
+Result makeSharedCase(const Settings& settings){
+	return measure(settings.iterations, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			auto ptr = Policy::template makeShared<Derived>(static_cast<int>(i));
+			doNotOptimise(ptr);
+		}
+	});
+}
+
+template<typename Policy>
+Result makeUniqueCase(const Settings& settings){
+	return measure(settings.iterations, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			auto ptr = Policy::template makeUnique<Derived>(static_cast<int>(i));
+			doNotOptimise(ptr);
+		}
+	});
+}
+
+template<typename Policy>
+Result copyCase(const Settings& settings){
+	auto source = Policy::template makeShared<Derived>(1);
+	return measure(settings.iterations, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			auto copy = source;
+			doNotOptimise(copy);
+		}
+	});
+}
+
+template<typename Policy>
+Result moveCase(const Settings& settings){
+	auto first = Policy::template makeShared<Derived>(1);
+	decltype(first) second;
+	return measure(settings.iterations * 2, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			second = std::move(first);
+			doNotOptimise(second);
+			first = std::move(second);
+			doNotOptimise(first);
+		}
+	});
+}
+
+template<typename Policy>
+Result pinCase(const Settings& settings){
+	auto source = Policy::template makeShared<Derived>(1);
+	typename Policy::template Weak<Derived> weak = source;
+	return measure(settings.iterations, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			auto pinned = Policy::pin(weak);
+			doNotOptimise(pinned);
+		}
+	});
+}
+
+template<typename Policy>
+Result staticCastCase(const Settings& settings){
+	typename Policy::template Shared<Base> source = Policy::template makeShared<Derived>(1);
+	return measure(settings.iterations, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			auto cast = Policy::template staticCast<Derived>(source);
+			doNotOptimise(cast);
+		}
+	});
+}
+
+template<typename Policy>
+Result moveCastCase(const Settings& settings){
+	typename Policy::template Shared<Base> source = Policy::template makeShared<Derived>(1);
+	return measure(settings.iterations * 2, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			auto cast = Policy::template staticCast<Derived>(std::move(source));
+			doNotOptimise(cast);
+			source = Policy::template staticCast<Base>(std::move(cast));
+			doNotOptimise(source);
+		}
+	});
+}
+
+template<typename Policy>
+Result dynamicCastCase(const Settings& settings){
+	typename Policy::template Shared<Base> source = Policy::template makeShared<Derived>(1);
+	return measure(settings.iterations, [&](){
+		for(std::size_t i = 0; i < settings.iterations; ++i){
+			auto cast = Policy::template dynamicCast<Derived>(source);
+			doNotOptimise(cast);
+		}
+	});
+}
+
+//Only the release of the last reference is timed, the objects are created up front
+template<typename Policy>
+Result destructionCase(const Settings& settings){
+	std::vector<typename Policy::template Shared<Derived>> ptrs;
+	ptrs.reserve(settings.containerSize);
+	for(std::size_t i = 0; i < settings.containerSize; ++i){
+		ptrs.push_back(Policy::template makeShared<Derived>(static_cast<int>(i)));
+	}
+
+	return measure(settings.containerSize, [&](){
+		for(auto& ptr : ptrs){
+			ptr.reset();
+		}
+	});
+}
+
+template<typename Policy>
+Result contentionCase(const Settings& settings){
+	if(!Policy::threadSafe){
+		return Result();
+	}
+
+	auto source = Policy::template makeShared<Derived>(1);
+	std::atomic<bool> go{ false };
+	std::vector<std::thread> threads;
+
+	const std::size_t perThread = settings.iterations / settings.threads;
+	return measure(perThread * settings.threads, [&](){
+		for(unsigned t = 0; t < settings.threads; ++t){
+			threads.emplace_back([&](){
+				while(!go.load(std::memory_order_acquire)){
+				}
+				for(std::size_t i = 0; i < perThread; ++i){
+					auto copy = source;
+					doNotOptimise(copy);
+				}
+			});
+		}
+		go.store(true, std::memory_order_release);
+		for(auto& thread : threads){
+			thread.join();
+		}
+	});
+}
+
+template<typename Policy>
+Result sortCase(const Settings& settings){
+	std::mt19937 random(42);
+	std::vector<typename Policy::template Shared<Derived>> ptrs;
+	ptrs.reserve(settings.containerSize);
+	for(std::size_t i = 0; i < settings.containerSize; ++i){
+		ptrs.push_back(Policy::template makeShared<Derived>(static_cast<int>(random())));
+	}
+
+	return measure(settings.containerSize, [&](){
+		std::sort(ptrs.begin(), ptrs.end(), [](const auto& a, const auto& b){
+			return a->value < b->value;
+		});
+		doNotOptimise(ptrs);
+	});
+}
+
+//Grows a vector without reserving, so every reallocation moves (or copies) the existing pointers
+template<typename Policy>
+Result reallocateCase(const Settings& settings){
+	auto source = Policy::template makeShared<Derived>(1);
+	return measure(settings.containerSize, [&](){
+		std::vector<typename Policy::template Shared<Derived>> ptrs;
+		for(std::size_t i = 0; i < settings.containerSize; ++i){
+			ptrs.push_back(source);
+		}
+		doNotOptimise(ptrs);
+	});
+}
+
+//Same again with agm::PtrVector, which relocates the pointers with realloc instead of moving them one at a time
+template<typename Policy>
+Result relocateCase(const Settings& settings){
+	auto source = Policy::template makeShared<Derived>(1);
+	return measure(settings.containerSize, [&](){
+		typename Policy::template Vector<Derived> ptrs;
+		for(std::size_t i = 0; i < settings.containerSize; ++i){
+			Policy::pushBack(ptrs, source);
+		}
+		doNotOptimise(ptrs);
+	});
+}
+
+/////////REPORTING
+struct Case{
+	const char* name;
+	std::function<Result(const Settings&)> run[4];
+};
+
+static void printResult(const Result& result){
+	if(result.ran){
+		std::printf(" | %9.2f %9.3f", result.nsPerOp, result.allocsPerOp);
+	} else{
+		std::printf(" | %9s %9s", "-", "-");
+	}
+}
+
+template<typename Policy>
+static void addCases(std::vector<Case>& cases, int column){
+	static const char* names[] = { "makeShared", "makeUnique", "copy", "move", "pin", "staticCast", "staticCast rvalue", "dynamicCast", "destruction", "contended copy", "vector sort", "vector reallocate", "PtrVector realloc" };
+	static Result (*const functions[])(const Settings&) = {
+		makeSharedCase<Policy>, makeUniqueCase<Policy>, copyCase<Policy>, moveCase<Policy>, pinCase<Policy>, staticCastCase<Policy>, moveCastCase<Policy>,
+		dynamicCastCase<Policy>, destructionCase<Policy>, contentionCase<Policy>, sortCase<Policy>, reallocateCase<Policy>, relocateCase<Policy>
+	};
+
+	cases.resize(sizeof(names) / sizeof(names[0]));
+	for(std::size_t i = 0; i < cases.size(); ++i){
+		cases[i].name = names[i];
+		cases[i].run[column] = functions[i];
+	}
+}
+
+int main(int argc, char** argv){
+	Settings settings;
+	if(argc > 1){
+		settings.iterations = std::strtoull(argv[1], nullptr, 10);
+	}
+	if(argc > 2){
+		settings.containerSize = std::strtoull(argv[2], nullptr, 10);
+	}
+	if(argc > 3){
+		settings.threads = static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10));
+	}
+	if(settings.iterations == 0 || settings.containerSize == 0 || settings.threads == 0){
+		std::printf("usage: %s [iterations] [container size] [threads]\n", argv[0]);
+		return 1;
+	}
+
+	//libstdc++ skips the atomic operations in std::shared_ptr until the process has started a thread,
+	//start one up front so the std column is measured the way it runs in a threaded program
+	std::thread([](){}).join();
+
+	std::vector<Case> cases;
+	addCases<AgmPolicy<agm::Counter>>(cases, 0);
+	addCases<AgmPolicy<agm::AtomicCounter>>(cases, 1);
+	addCases<AgmPolicy<agm::BiasedCounter>>(cases, 2);
+	addCases<StdPolicy>(cases, 3);
+
+	std::printf("iterations: %zu, container size: %zu, threads: %u\n\n", settings.iterations, settings.containerSize, settings.threads);
+	std::printf("%-18s | %-19s | %-19s | %-19s | %-19s\n", "", "agm::Counter", "agm::AtomicCounter", "agm::BiasedCounter", "std");
+	std::printf("%-18s | %9s %9s | %9s %9s | %9s %9s | %9s %9s\n", "case", "ns/op", "allocs/op", "ns/op", "allocs/op", "ns/op", "allocs/op", "ns/op", "allocs/op");
+	for(const Case& benchmarkCase : cases){
+		std::printf("%-18s", benchmarkCase.name);
+		for(const auto& run : benchmarkCase.run){
+			printResult(run(settings));
+		}
+		std::printf("\n");
+	}
+
+	std::printf("\n%-18s | %19s | %19s\n", "sizeof", "agm", "std");
+	std::printf("%-18s | %19zu | %19zu\n", "shared pointer", sizeof(agm::SharedPtr<int>), sizeof(std::shared_ptr<int>));
+	std::printf("%-18s | %19zu | %19zu\n", "weak pointer", sizeof(agm::WeakPtr<int>), sizeof(std::weak_ptr<int>));
+	std::printf("%-18s | %19zu | %19zu\n", "unique pointer", sizeof(agm::UniquePtr<int>), sizeof(std::unique_ptr<int>));
+	std::printf("%-18s | %19zu | %19zu\n", "unique array", sizeof(agm::UniquePtr<int[]>), sizeof(std::unique_ptr<int[]>));
+	std::printf("%-18s | %19zu | %19s\n", "intrusive pointer", sizeof(agm::IntrusivePtr<Base>), "-");
+
+	return 0;
+}
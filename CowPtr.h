@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <type_traits>
+#include <utility>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////COPY ON WRITE POINTER
+	//Shares one immutable object between copies, so copying a CowPtr is a snapshot that costs a single increment.
+	//write() clones the object first if any other CowPtr is still sharing it, so only the copies that change pay for it.
+	//With an AtomicCounter the count is read with acquire, so a writer that finds itself alone sees every read the other
+	//owners made before letting go. A single CowPtr is not safe to copy on one thread while writing through it on another.
+	//There is no way to get a WeakPtr to the object, as pinning one could bring back a sharer while a write is under way
+	template<typename Type, typename CounterType = DefaultCounter>
+	class CowPtr{
+		static_assert(std::is_copy_constructible<Type>::value, "CowPtr clones the object with its copy constructor");
+		static_assert(HasExactCount<CounterType>::value, "CowPtr needs an exact count to know when it is the only owner");
+
+		template<typename OtherType, typename OtherCounterType, typename... ArgTypes>
+		friend CowPtr<OtherType, OtherCounterType> makeCow(ArgTypes&&... args);
+
+		//VARIABLES
+	private:
+		SharedPtr<Type, DefaultDeleter, CounterType> data;
+
+		//FUNCTIONS
+	public:
+		explicit constexpr CowPtr() noexcept = default;
+
+		const Type* get() const noexcept;
+
+		const Type* operator ->() const noexcept;
+		const Type& operator *() const noexcept;
+
+		//Clones the object if it is shared, the reference is only valid until this CowPtr is copied or assigned.
+		//An empty CowPtr gets a value initialised object first, or stops the program if Type can't be default constructed
+		Type& write();
+
+		//True if no other CowPtr shares the object, so write() won't clone it
+		bool isUnique() const noexcept;
+
+		void reset() noexcept;
+		void swap(CowPtr<Type, CounterType>& ptr) noexcept;
+
+		explicit operator bool() const noexcept;
+
+	private:
+		explicit CowPtr(SharedPtr<Type, DefaultDeleter, CounterType>&& inData) noexcept;
+	};
+
+	/////////TRIVIALLY RELOCATABLE
+	template<typename Type, typename CounterType>
+	struct IsTriviallyRelocatable<CowPtr<Type, CounterType>> : std::true_type{
+	};
+
+	/////////HELPER FUNCTIONS
+	template<typename Type, typename CounterType = DefaultCounter, typename... ArgTypes>
+	CowPtr<Type, CounterType> makeCow(ArgTypes&&... args);
+
+	template<typename Type, typename CounterType>
+	void swap(CowPtr<Type, CounterType>& lptr, CowPtr<Type, CounterType>& rptr) noexcept;
+}
+}
+
+/////////INLINE INCLUDE
+#include "CowPtr.inl"
@@ -0,0 +1,66 @@
+/////////COPY ON WRITE POINTER
+template<typename Type, typename CounterType>
+inline agm::CowPtr<Type, CounterType>::CowPtr(SharedPtr<Type, DefaultDeleter, CounterType>&& inData) noexcept
+	: data(std::move(inData)){
+}
+
+template<typename Type, typename CounterType>
+inline const Type* agm::CowPtr<Type, CounterType>::get() const noexcept{
+	return data.get();
+}
+
+template<typename Type, typename CounterType>
+inline const Type* agm::CowPtr<Type, CounterType>::operator ->() const noexcept{
+	return data.operator->();
+}
+
+template<typename Type, typename CounterType>
+inline const Type& agm::CowPtr<Type, CounterType>::operator *() const noexcept{
+	return *data;
+}
+
+template<typename Type, typename CounterType>
+inline Type& agm::CowPtr<Type, CounterType>::write(){
+	if(!data){
+		if constexpr(std::is_default_constructible<Type>::value){
+			data = makeShared<Type, CounterType>();
+		} else{
+			usageFailure("write() on an empty CowPtr whose type can't be default constructed", AGM_FUNCTION_NAME);
+		}
+	} else if(!isUnique()){
+		//Only replaces the shared object once the clone has been made, so a throwing copy leaves this unchanged
+		data = makeShared<Type, CounterType>(static_cast<const Type&>(*data));
+	}
+	return *data;
+}
+
+template<typename Type, typename CounterType>
+inline bool agm::CowPtr<Type, CounterType>::isUnique() const noexcept{
+	return data.ref && data.ref->check() == 1;
+}
+
+template<typename Type, typename CounterType>
+inline void agm::CowPtr<Type, CounterType>::reset() noexcept{
+	data.reset();
+}
+
+template<typename Type, typename CounterType>
+inline void agm::CowPtr<Type, CounterType>::swap(CowPtr<Type, CounterType>& ptr) noexcept{
+	data.swap(ptr.data);
+}
+
+template<typename Type, typename CounterType>
+inline agm::CowPtr<Type, CounterType>::operator bool() const noexcept{
+	return static_cast<bool>(data);
+}
+
+/////////HELPER FUNCTIONS
+template<typename Type, typename CounterType, typename... ArgTypes>
+inline agm::CowPtr<Type, CounterType> agm::AGM_ABI_NAMESPACE::makeCow(ArgTypes&&... args){
+	return CowPtr<Type, CounterType>(makeShared<Type, CounterType>(std::forward<ArgTypes>(args)...));
+}
+
+template<typename Type, typename CounterType>
+inline void agm::AGM_ABI_NAMESPACE::swap(CowPtr<Type, CounterType>& lptr, CowPtr<Type, CounterType>& rptr) noexcept{
+	lptr.swap(rptr);
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////CYCLE STATS
+	//What a single call to CycleCollector::collect() did
+	struct CycleStats{
+		std::size_t reclaimedObjects = 0;
+		//Sum of getCollectableSize() over the reclaimed objects
+		std::size_t reclaimedBytes = 0;
+
+		//Objects visited while looking for cycles, including the ones that turned out to be alive
+		std::size_t scannedObjects = 0;
+
+		//Candidates still waiting because the budget ran out, collect again later if this isn't zero
+		std::size_t remainingCandidates = 0;
+	};
+
+	/////////CYCLE TRACER
+	//Passed to CollectableNode::traceEdges, which has to call it on every SharedPtr the object holds to another collectable object
+	template<typename CounterType>
+	class CycleTracer{
+		friend class CycleCollector<CounterType>;
+
+		//VARIABLES
+	private:
+		CycleCollector<CounterType>& collector;
+		//Set while a garbage cycle is being broken up, every traced pointer is reset instead of being followed
+		bool clearing;
+
+		//FUNCTIONS
+	public:
+		CycleTracer(const CycleTracer<CounterType>& other) = delete;
+
+		template<typename Type, typename DeleterType>
+		void operator ()(SharedPtr<Type, DeleterType, CounterType>& ptr);
+
+		CycleTracer<CounterType>& operator =(const CycleTracer<CounterType>& other) = delete;
+
+	private:
+		CycleTracer(CycleCollector<CounterType>& inCollector, bool inClearing);
+	};
+
+	/////////COLLECTABLE NODE
+	//Base of every object the cycle collector can look through. The collector's bookkeeping lives here rather than in a
+	//side table, so finding a node from an edge is free. Copying an object does not copy its state
+	template<typename CounterType>
+	class CollectableNode{
+		friend class CycleCollector<CounterType>;
+
+	public:
+		typedef CycleTracer<CounterType> Tracer;
+
+		//VARIABLES
+	private:
+		enum class Colour : std::uint8_t{
+			Black,
+			Grey,
+			White,
+		};
+
+		//Strong count minus the references from other grey objects, only meaningful while the object is grey
+		int trialCount = 0;
+		Colour colour = Colour::Black;
+		std::atomic<bool> buffered{ false };
+
+		//FUNCTIONS
+	public:
+		virtual ~CollectableNode() = default;
+
+		virtual void traceEdges(Tracer& tracer) = 0;
+		virtual std::size_t getCollectableSize() const = 0;
+
+	protected:
+		CollectableNode() = default;
+		CollectableNode(const CollectableNode<CounterType>& other) noexcept;
+
+		CollectableNode<CounterType>& operator =(const CollectableNode<CounterType>& other) noexcept;
+	};
+
+	/////////COLLECTABLE
+	//Inherit from this to let the cycle collector reclaim strong reference cycles through a type, and override traceEdges
+	template<typename Type, typename CounterType = DefaultCounter>
+	class Collectable : public CollectableNode<CounterType>{
+	public:
+		typedef Type CollectableType;
+
+		//FUNCTIONS
+	public:
+		virtual std::size_t getCollectableSize() const override;
+	};
+
+	/////////CYCLE COLLECTOR
+	//Trial deletion (Bacon and Rajan, "Concurrent Cycle Collection in Reference Counted Systems", synchronous version).
+	//A collectable object becomes a candidate root when a SharedPtr to it is released and others are left, as that is the
+	//only way a cycle can become unreachable. collect() takes the candidates a slice at a time, subtracts the references
+	//the objects reachable from them hold to each other, and any object left with no outside references is garbage.
+	//Each slice starts and finishes within one call, so the graph can be changed freely between calls, but not during one.
+	//Releases can come from any thread. The candidates hold a weak reference, so the memory of a candidate that is
+	//destroyed normally is only given back when it is next collected
+	template<typename CounterType = DefaultCounter>
+	class CycleCollector{
+		static_assert(!IsStrongOnly<CounterType>::value, "The cycle collector holds its candidates with weak references");
+		static_assert(HasExactCount<CounterType>::value, "Trial deletion subtracts internal references from the exact strong count");
+
+		template<typename Type, typename DeleterType, typename OtherCounterType> friend class SharedPtr;
+		friend class CycleTracer<CounterType>;
+
+		//VARIABLES
+	private:
+		typedef CollectableNode<CounterType> Node;
+		typedef typename Node::Colour Colour;
+
+		struct Entry{
+			Node* node;
+			ControlBlock<CounterType>* block;
+			//Gives back a strong reference the same way the pointer it was found through would
+			void (*release)(ControlBlock<CounterType>* block);
+		};
+
+		//Candidates taken per slice, the budget is checked between slices
+		static constexpr std::size_t sliceSize = 64;
+
+		std::mutex lock;
+		std::vector<Entry> roots;
+
+		//Scratch space for collect(), kept to avoid allocating every frame
+		std::vector<Entry> slice;
+		std::vector<Entry> visited;
+		std::vector<Entry> pending;
+		std::vector<Entry> edges;
+
+		bool collecting = false;
+
+		//FUNCTIONS
+	public:
+		static CycleCollector<CounterType>& get();
+
+		//Keeps taking slices of candidates until there are none left or budget has passed. At least one slice is always
+		//collected, so a call can overrun by as long as one slice takes
+		CycleStats collect(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+
+		std::size_t getCandidateCount();
+
+	private:
+		CycleCollector() = default;
+
+		template<typename DeleterType>
+		static void possibleRoot(const Node* node, ControlBlock<CounterType>* block);
+
+		void collectSlice(CycleStats& stats);
+
+		void markGrey(const Entry& root);
+		void scan(const Entry& root);
+		void scanBlack(const Entry& root);
+		void collectWhite(CycleStats& stats);
+
+		//Fills edges with the collectable objects node points to
+		void traceEdges(Node* node);
+
+		static void dropCandidate(const Entry& entry);
+		template<typename DeleterType> static void releaseHold(ControlBlock<CounterType>* block);
+	};
+
+	/////////HELPER FUNCTIONS
+	template<typename CounterType = DefaultCounter>
+	CycleStats collectCycles(std::chrono::nanoseconds budget = std::chrono::nanoseconds::max());
+}
+}
+
+/////////INLINE INCLUDE
+#include "CycleCollector.inl"
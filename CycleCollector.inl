@@ -0,0 +1,264 @@
+/////////CYCLE TRACER
+template<typename CounterType>
+inline agm::CycleTracer<CounterType>::CycleTracer(CycleCollector<CounterType>& inCollector, bool inClearing)
+	: collector(inCollector)
+	, clearing(inClearing){
+}
+
+template<typename CounterType>
+template<typename Type, typename DeleterType>
+inline void agm::CycleTracer<CounterType>::operator ()(SharedPtr<Type, DeleterType, CounterType>& ptr){
+	static_assert(IsCollectable<Type, CounterType>::value, "Only pointers to collectable objects with the same counter can be traced");
+
+	if(clearing){
+		ptr.reset();
+	} else if(ptr.get()){
+		const CollectableNode<CounterType>* node = ptr.get();
+		collector.edges.push_back({ const_cast<CollectableNode<CounterType>*>(node), ptr.ref, &CycleCollector<CounterType>::template releaseHold<DeleterType> });
+	}
+}
+
+/////////COLLECTABLE NODE
+template<typename CounterType>
+inline agm::CollectableNode<CounterType>::CollectableNode(const CollectableNode<CounterType>&) noexcept{
+}
+
+template<typename CounterType>
+inline agm::CollectableNode<CounterType>& agm::CollectableNode<CounterType>::operator =(const CollectableNode<CounterType>&) noexcept{
+	return *this;
+}
+
+/////////COLLECTABLE
+template<typename Type, typename CounterType>
+inline std::size_t agm::Collectable<Type, CounterType>::getCollectableSize() const{
+	return sizeof(Type);
+}
+
+/////////CYCLE COLLECTOR
+template<typename CounterType>
+inline agm::CycleCollector<CounterType>& agm::CycleCollector<CounterType>::get(){
+	//Never destroyed so pointers released during static destruction can still be added as candidates
+	static CycleCollector<CounterType>* collector = new CycleCollector<CounterType>();
+	return *collector;
+}
+
+template<typename CounterType>
+inline agm::CycleStats agm::CycleCollector<CounterType>::collect(std::chrono::nanoseconds budget){
+	CycleStats stats;
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		//Destructors run by a collection can't start another one
+		if(collecting){
+			stats.remainingCandidates = roots.size();
+			return stats;
+		}
+		collecting = true;
+	}
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	do{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			const std::size_t count = std::min(roots.size(), sliceSize);
+			slice.assign(roots.end() - count, roots.end());
+			roots.resize(roots.size() - count);
+		}
+		if(slice.empty()){
+			break;
+		}
+
+		collectSlice(stats);
+	} while(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start) < budget);
+
+	std::lock_guard<std::mutex> guard(lock);
+	collecting = false;
+	stats.remainingCandidates = roots.size();
+	return stats;
+}
+
+template<typename CounterType>
+inline std::size_t agm::CycleCollector<CounterType>::getCandidateCount(){
+	std::lock_guard<std::mutex> guard(lock);
+	return roots.size();
+}
+
+template<typename CounterType>
+template<typename DeleterType>
+inline void agm::CycleCollector<CounterType>::possibleRoot(const Node* node, ControlBlock<CounterType>* block){
+	//The reference being released is still counted, so anything above one means the object will survive it
+	if(!node || block->check() <= 1){
+		return;
+	}
+
+	Node* candidate = const_cast<Node*>(node);
+	if(candidate->buffered.load(std::memory_order_relaxed) || candidate->buffered.exchange(true, std::memory_order_relaxed)){
+		return;
+	}
+
+	block->weakGrab();
+
+	CycleCollector<CounterType>& collector = get();
+	std::lock_guard<std::mutex> guard(collector.lock);
+	collector.roots.push_back({ candidate, block, &releaseHold<DeleterType> });
+}
+
+template<typename CounterType>
+inline void agm::CycleCollector<CounterType>::collectSlice(CycleStats& stats){
+	visited.clear();
+
+	//Candidates that were destroyed normally since they were added only have to give their weak reference back
+	for(const Entry& root : slice){
+		if(root.block->check() > 0){
+			root.node->buffered.store(false, std::memory_order_relaxed);
+			markGrey(root);
+		}
+	}
+	for(const Entry& root : slice){
+		if(root.block->check() > 0){
+			scan(root);
+		}
+	}
+	collectWhite(stats);
+
+	stats.scannedObjects += visited.size();
+
+	for(const Entry& root : slice){
+		dropCandidate(root);
+	}
+	slice.clear();
+}
+
+template<typename CounterType>
+inline void agm::CycleCollector<CounterType>::markGrey(const Entry& root){
+	if(root.node->colour == Colour::Grey){
+		return;
+	}
+
+	root.node->colour = Colour::Grey;
+	root.node->trialCount = root.block->check();
+	visited.push_back(root);
+	pending.push_back(root);
+
+	while(!pending.empty()){
+		const Entry entry = pending.back();
+		pending.pop_back();
+
+		traceEdges(entry.node);
+		for(const Entry& edge : edges){
+			if(edge.node->colour != Colour::Grey){
+				edge.node->colour = Colour::Grey;
+				edge.node->trialCount = edge.block->check();
+				visited.push_back(edge);
+				pending.push_back(edge);
+			}
+			--edge.node->trialCount;
+		}
+	}
+}
+
+template<typename CounterType>
+inline void agm::CycleCollector<CounterType>::scan(const Entry& root){
+	pending.push_back(root);
+
+	while(!pending.empty()){
+		const Entry entry = pending.back();
+		pending.pop_back();
+
+		if(entry.node->colour != Colour::Grey){
+			continue;
+		}
+
+		//Still referenced from outside the grey objects, so it and everything it points to is alive
+		if(entry.node->trialCount > 0){
+			scanBlack(entry);
+		} else{
+			entry.node->colour = Colour::White;
+			traceEdges(entry.node);
+			pending.insert(pending.end(), edges.begin(), edges.end());
+		}
+	}
+}
+
+template<typename CounterType>
+inline void agm::CycleCollector<CounterType>::scanBlack(const Entry& root){
+	//Shares the stack with scan(), only the entries above where it started are its own
+	const std::size_t base = pending.size();
+
+	root.node->colour = Colour::Black;
+	pending.push_back(root);
+
+	while(pending.size() > base){
+		const Entry entry = pending.back();
+		pending.pop_back();
+
+		traceEdges(entry.node);
+		for(const Entry& edge : edges){
+			++edge.node->trialCount;
+			if(edge.node->colour != Colour::Black){
+				edge.node->colour = Colour::Black;
+				pending.push_back(edge);
+			}
+		}
+	}
+}
+
+template<typename CounterType>
+inline void agm::CycleCollector<CounterType>::collectWhite(CycleStats& stats){
+	//Hold every white object first so none of them can be destroyed while the cycles are being broken up
+	for(const Entry& entry : visited){
+		if(entry.node->colour == Colour::White){
+			entry.node->colour = Colour::Black;
+			//Stops the pointers reset below from adding them as candidates again
+			entry.node->buffered.store(true, std::memory_order_relaxed);
+			entry.block->grab();
+
+			++stats.reclaimedObjects;
+			stats.reclaimedBytes += entry.node->getCollectableSize();
+			pending.push_back(entry);
+		}
+	}
+
+	CycleTracer<CounterType> tracer(*this, true);
+	for(const Entry& entry : pending){
+		entry.node->traceEdges(tracer);
+	}
+
+	//Giving the holds back destroys the objects through their own deleters
+	for(const Entry& entry : pending){
+		entry.release(entry.block);
+	}
+	pending.clear();
+}
+
+template<typename CounterType>
+inline void agm::CycleCollector<CounterType>::traceEdges(Node* node){
+	edges.clear();
+	CycleTracer<CounterType> tracer(*this, false);
+	node->traceEdges(tracer);
+}
+
+template<typename CounterType>
+inline void agm::CycleCollector<CounterType>::dropCandidate(const Entry& entry){
+	if(entry.block->weakRelease() == 0){
+		entry.block->destroyBlock();
+	}
+}
+
+template<typename CounterType>
+template<typename DeleterType>
+inline void agm::CycleCollector<CounterType>::releaseHold(ControlBlock<CounterType>* block){
+	if(block->release() == 0){
+		if constexpr(IsDeferredDeleter<DeleterType>::value){
+			DeleterType::defer(&ControlBlock<CounterType>::reclaim, block);
+		} else{
+			ControlBlock<CounterType>::reclaim(block);
+		}
+	}
+}
+
+/////////HELPER FUNCTIONS
+template<typename CounterType>
+inline agm::CycleStats agm::AGM_ABI_NAMESPACE::collectCycles(std::chrono::nanoseconds budget){
+	return CycleCollector<CounterType>::get().collect(budget);
+}
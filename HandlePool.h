@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////HANDLE
+	//A weak reference into a HandlePool. The generation changes every time a slot is freed, so a handle to a
+	//destroyed object stops resolving without anything having to be kept alive for it
+	template<typename Type>
+	class Handle{
+		template<typename OtherType, typename CounterType> friend class HandlePool;
+
+		//VARIABLES
+	private:
+		std::uint32_t index = 0;
+		std::uint32_t generation = 0;
+
+		//FUNCTIONS
+	public:
+		Handle() = default;
+
+		std::uint32_t getIndex() const;
+		std::uint32_t getGeneration() const;
+
+		bool operator ==(const Handle<Type>& other) const;
+		bool operator !=(const Handle<Type>& other) const;
+
+	private:
+		Handle(std::uint32_t inIndex, std::uint32_t inGeneration);
+	};
+
+	/////////HANDLE BLOCK
+	//Control block made the first time a slot is shared. The pool holds one strong reference until the object is
+	//destroyed through it, so the slot is only recycled once the SharedPtrs are gone as well
+	template<typename Type, typename CounterType>
+	class HandleBlock : public ControlBlock<CounterType>{
+		//VARIABLES
+	private:
+		HandlePool<Type, CounterType>* pool;
+		std::uint32_t index;
+
+		//FUNCTIONS
+	public:
+		HandleBlock(HandlePool<Type, CounterType>* inPool, std::uint32_t inIndex);
+
+		virtual void destroyObject() override;
+		virtual void destroyBlock() override;
+	};
+
+	/////////HANDLE POOL
+	//Stores objects in one fixed size array of slots. A slot's generation is odd while it holds an object,
+	//so resolving a Handle is a bounds check and a generation compare on a single array element.
+	//Freed slots go on a free list to be reused. Not thread safe, and has to outlive any SharedPtr made by share()
+	template<typename Type, typename CounterType = DefaultCounter>
+	class HandlePool{
+		friend class HandleBlock<Type, CounterType>;
+
+		//VARIABLES
+	private:
+		struct Slot{
+			union{
+				Type object;
+			};
+			std::uint32_t generation = 0;
+			std::uint32_t nextFree = 0;
+			HandleBlock<Type, CounterType>* block = nullptr;
+
+			Slot(){}
+			~Slot(){}
+		};
+
+		static constexpr std::uint32_t noSlot = ~std::uint32_t(0);
+
+		Slot* slots = nullptr;
+		std::uint32_t capacity = 0;
+		//Slots past this have never been used, so the free list doesn't need building up front
+		std::uint32_t used = 0;
+		std::uint32_t freeHead = noSlot;
+		std::size_t count = 0;
+
+		//FUNCTIONS
+	public:
+		explicit HandlePool(std::uint32_t inCapacity);
+
+		HandlePool(const HandlePool<Type, CounterType>& other) = delete;
+
+		~HandlePool();
+
+		//Returns an invalid handle if the pool is full
+		template<typename... ArgTypes> Handle<Type> create(ArgTypes&&... args);
+		void destroy(Handle<Type> handle);
+
+		bool isValid(Handle<Type> handle) const;
+		Type* get(Handle<Type> handle) const;
+
+		//The object stays alive until both the pool and the returned SharedPtrs have released it
+		SharedPtr<Type, DefaultDeleter, CounterType> share(Handle<Type> handle);
+
+		std::size_t size() const;
+		std::size_t getCapacity() const;
+
+		HandlePool<Type, CounterType>& operator =(const HandlePool<Type, CounterType>& other) = delete;
+
+	private:
+		Slot* resolve(Handle<Type> handle) const;
+		void freeSlot(std::uint32_t index);
+	};
+}
+}
+
+/////////INLINE INCLUDE
+#include "HandlePool.inl"
@@ -0,0 +1,174 @@
+#include <new>
+#include <utility>
+
+/////////HANDLE
+template<typename Type>
+inline agm::Handle<Type>::Handle(std::uint32_t inIndex, std::uint32_t inGeneration)
+	: index(inIndex)
+	, generation(inGeneration){
+}
+
+template<typename Type>
+inline std::uint32_t agm::Handle<Type>::getIndex() const{
+	return index;
+}
+
+template<typename Type>
+inline std::uint32_t agm::Handle<Type>::getGeneration() const{
+	return generation;
+}
+
+template<typename Type>
+inline bool agm::Handle<Type>::operator ==(const agm::Handle<Type>& other) const{
+	return index == other.index && generation == other.generation;
+}
+
+template<typename Type>
+inline bool agm::Handle<Type>::operator !=(const agm::Handle<Type>& other) const{
+	return !(*this == other);
+}
+
+/////////HANDLE BLOCK
+template<typename Type, typename CounterType>
+inline agm::HandleBlock<Type, CounterType>::HandleBlock(agm::HandlePool<Type, CounterType>* inPool, std::uint32_t inIndex)
+	: pool(inPool)
+	, index(inIndex){
+	Telemetry::blockCreated<Type>(this);
+}
+
+template<typename Type, typename CounterType>
+inline void agm::HandleBlock<Type, CounterType>::destroyObject(){
+	Telemetry::objectDestroyed<Type>();
+	pool->freeSlot(index);
+}
+
+template<typename Type, typename CounterType>
+inline void agm::HandleBlock<Type, CounterType>::destroyBlock(){
+	Telemetry::blockDestroyed(this);
+	delete this;
+}
+
+/////////HANDLE POOL
+template<typename Type, typename CounterType>
+inline agm::HandlePool<Type, CounterType>::HandlePool(std::uint32_t inCapacity)
+	: slots(new Slot[inCapacity])
+	, capacity(inCapacity){
+}
+
+template<typename Type, typename CounterType>
+inline agm::HandlePool<Type, CounterType>::~HandlePool(){
+	for(std::uint32_t i = 0; i < used; ++i){
+		if(slots[i].generation & 1){
+			destroy(Handle<Type>(i, slots[i].generation));
+		}
+	}
+	delete[] slots;
+}
+
+template<typename Type, typename CounterType>
+template<typename... ArgTypes>
+inline agm::Handle<Type> agm::HandlePool<Type, CounterType>::create(ArgTypes&&... args){
+	std::uint32_t index = freeHead;
+	if(index == noSlot){
+		if(used == capacity){
+			return Handle<Type>();
+		}
+		index = used;
+	}
+
+	Slot& slot = slots[index];
+	new(&slot.object) Type(std::forward<ArgTypes>(args)...);
+
+	//Only take the slot once the object has been constructed, in case it throws
+	if(index == freeHead){
+		freeHead = slot.nextFree;
+	} else{
+		++used;
+	}
+	++slot.generation;
+	++count;
+
+	return Handle<Type>(index, slot.generation);
+}
+
+template<typename Type, typename CounterType>
+inline void agm::HandlePool<Type, CounterType>::destroy(agm::Handle<Type> handle){
+	Slot* slot = resolve(handle);
+	if(!slot){
+		return;
+	}
+
+	//Invalidate the handles straight away, the object itself may still be held by SharedPtrs
+	++slot->generation;
+	--count;
+
+	if(HandleBlock<Type, CounterType>* block = slot->block){
+		if(block->release() == 0){
+			ControlBlock<CounterType>::reclaim(block);
+		}
+	} else{
+		freeSlot(handle.index);
+	}
+}
+
+template<typename Type, typename CounterType>
+inline bool agm::HandlePool<Type, CounterType>::isValid(agm::Handle<Type> handle) const{
+	return resolve(handle) != nullptr;
+}
+
+template<typename Type, typename CounterType>
+inline Type* agm::HandlePool<Type, CounterType>::get(agm::Handle<Type> handle) const{
+	Slot* slot = resolve(handle);
+	return slot ? &slot->object : nullptr;
+}
+
+template<typename Type, typename CounterType>
+inline agm::SharedPtr<Type, agm::DefaultDeleter, CounterType> agm::HandlePool<Type, CounterType>::share(agm::Handle<Type> handle){
+	SharedPtr<Type, DefaultDeleter, CounterType> outPtr;
+
+	Slot* slot = resolve(handle);
+	if(!slot){
+		return outPtr;
+	}
+
+	if(!slot->block){
+		slot->block = new HandleBlock<Type, CounterType>(this, handle.index);
+		//The pool's own reference
+		slot->block->grab();
+		outPtr.initBlock(&slot->object, slot->block);
+	} else{
+		outPtr.init(&slot->object, slot->block);
+	}
+	return outPtr;
+}
+
+template<typename Type, typename CounterType>
+inline std::size_t agm::HandlePool<Type, CounterType>::size() const{
+	return count;
+}
+
+template<typename Type, typename CounterType>
+inline std::size_t agm::HandlePool<Type, CounterType>::getCapacity() const{
+	return capacity;
+}
+
+template<typename Type, typename CounterType>
+inline typename agm::HandlePool<Type, CounterType>::Slot* agm::HandlePool<Type, CounterType>::resolve(agm::Handle<Type> handle) const{
+	if(handle.index < used && slots[handle.index].generation == handle.generation && (handle.generation & 1)){
+		return &slots[handle.index];
+	}
+	return nullptr;
+}
+
+template<typename Type, typename CounterType>
+inline void agm::HandlePool<Type, CounterType>::freeSlot(std::uint32_t index){
+	Slot& slot = slots[index];
+	slot.object.~Type();
+	slot.block = nullptr;
+
+	//A slot whose generation is about to wrap is retired, so an old handle can never match it again
+	if(slot.generation != ~std::uint32_t(0) - 1){
+		slot.nextFree = freeHead;
+		freeHead = index;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////INLINE POINTER
+	//Owns a single polymorphic object like UniquePtr, but objects of up to Size bytes are built in a buffer inside the
+	//pointer instead of on the heap, so a std::vector of them keeps the objects next to each other. Moving one moves the
+	//object into the new buffer, so inline objects have to be nothrow move constructible. Anything bigger, more aligned
+	//than std::max_align_t or handed over as a raw pointer is owned on the heap and destroyed with DeleterType.
+	//Deferred deleters never store objects inline, so every destructor still runs where the deleter wants it to
+	template<typename Type, std::size_t Size = 48, typename DeleterType = DefaultDeleter>
+	class InlinePtr : public PtrBase<Type, InlinePtr<Type, Size, DeleterType>>, private DeleterStorage<DeleterType>{
+		friend class PtrBase<Type, InlinePtr<Type, Size, DeleterType>>;
+
+		//VARIABLES
+	public:
+		static constexpr std::size_t alignment = alignof(std::max_align_t);
+
+		template<typename OtherType>
+		static constexpr bool fitsInline = sizeof(OtherType) <= Size && alignof(OtherType) <= alignment && std::is_nothrow_move_constructible<OtherType>::value && !IsDeferredDeleter<DeleterType>::value;
+
+	private:
+		//Moves the object in source to destination and returns it, or just destroys it if destination is null
+		typedef Type* (*ManagerType)(void* source, void* destination) noexcept;
+
+		//Null while the object is on the heap. Kept before the buffer so it fills the gap after the object pointer
+		ManagerType manager = nullptr;
+		alignas(alignment) unsigned char storage[Size];
+
+		//FUNCTIONS
+	public:
+		explicit InlinePtr() noexcept = default;
+		explicit InlinePtr(Type* inObject) noexcept;
+		InlinePtr(Type* inObject, DeleterType inDeleter) noexcept;
+
+		InlinePtr(InlinePtr<Type, Size, DeleterType>&& ptr) noexcept;
+
+		//Moves the object into the buffer if it fits and OtherType is final, as then it can't be part of something
+		//bigger. Otherwise it takes over the heap object
+		template<typename OtherType> InlinePtr(UniquePtr<OtherType, DeleterType>&& ptr) noexcept;
+
+		~InlinePtr() noexcept;
+
+		//Destroys the current object and builds a new one, inline if it fits. Empty if the constructor throws
+		template<typename OtherType, typename... ArgTypes> OtherType& emplace(ArgTypes&&... args);
+
+		bool isInline() const noexcept;
+
+		InlinePtr<Type, Size, DeleterType> move() noexcept;
+
+		using DeleterStorage<DeleterType>::getDeleter;
+
+		Type* operator ->() noexcept;
+		Type* operator ->() const noexcept;
+
+		Type& operator *() noexcept;
+		Type& operator *() const noexcept;
+
+		InlinePtr<Type, Size, DeleterType>& operator =(InlinePtr<Type, Size, DeleterType>&& ptr) noexcept;
+		template<typename OtherType> InlinePtr<Type, Size, DeleterType>& operator =(UniquePtr<OtherType, DeleterType>&& ptr) noexcept;
+
+	protected:
+		void free() noexcept;
+
+	private:
+		void take(InlinePtr<Type, Size, DeleterType>& ptr) noexcept;
+		template<typename OtherType> void take(UniquePtr<OtherType, DeleterType>& ptr) noexcept;
+
+		template<typename OtherType> static Type* manage(void* source, void* destination) noexcept;
+		static void reclaim(void* inObject) noexcept;
+	};
+
+	/////////HELPER FUNCTIONS
+	template<typename Type, typename OtherType = Type, std::size_t Size = 48, typename... ArgTypes>
+	InlinePtr<Type, Size> makeInline(ArgTypes&&... args);
+}
+}
+
+/////////INLINE INCLUDE
+#include "InlinePtr.inl"
@@ -0,0 +1,175 @@
+/////////INLINE POINTER
+template<typename Type, std::size_t Size, typename DeleterType>
+inline agm::InlinePtr<Type, Size, DeleterType>::InlinePtr(Type* inObject) noexcept{
+	this->object = inObject;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline agm::InlinePtr<Type, Size, DeleterType>::InlinePtr(Type* inObject, DeleterType inDeleter) noexcept
+	: DeleterStorage<DeleterType>(std::move(inDeleter)){
+	this->object = inObject;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline agm::InlinePtr<Type, Size, DeleterType>::InlinePtr(agm::InlinePtr<Type, Size, DeleterType>&& ptr) noexcept
+	: DeleterStorage<DeleterType>(std::move(ptr.getDeleter())){
+	take(ptr);
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+template<typename OtherType>
+inline agm::InlinePtr<Type, Size, DeleterType>::InlinePtr(agm::UniquePtr<OtherType, DeleterType>&& ptr) noexcept{
+	take(ptr);
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline agm::InlinePtr<Type, Size, DeleterType>::~InlinePtr() noexcept{
+	free();
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+template<typename OtherType, typename... ArgTypes>
+inline OtherType& agm::InlinePtr<Type, Size, DeleterType>::emplace(ArgTypes&&... args){
+	static_assert(std::is_convertible<OtherType*, Type*>::value, "OtherType has to derive from Type");
+
+	free();
+	if constexpr(fitsInline<OtherType>){
+		OtherType* created = new(storage) OtherType(std::forward<ArgTypes>(args)...);
+		this->object = created;
+		manager = &manage<OtherType>;
+		return *created;
+	} else{
+		static_assert(std::is_same<DeleterType, DefaultDeleter>::value, "Objects that don't fit inline are allocated with new, so they need the DefaultDeleter");
+		static_assert(std::is_same<std::remove_cv_t<OtherType>, std::remove_cv_t<Type>>::value || std::has_virtual_destructor<Type>::value, "Objects that don't fit inline are deleted through Type, which needs a virtual destructor");
+
+		OtherType* created = new OtherType(std::forward<ArgTypes>(args)...);
+		this->object = created;
+		return *created;
+	}
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline bool agm::InlinePtr<Type, Size, DeleterType>::isInline() const noexcept{
+	return manager != nullptr;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline agm::InlinePtr<Type, Size, DeleterType> agm::InlinePtr<Type, Size, DeleterType>::move() noexcept{
+	return InlinePtr<Type, Size, DeleterType>(std::move(*this));
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline Type* agm::InlinePtr<Type, Size, DeleterType>::operator ->() noexcept{
+	return this->access();
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline Type* agm::InlinePtr<Type, Size, DeleterType>::operator ->() const noexcept{
+	return this->access();
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline Type& agm::InlinePtr<Type, Size, DeleterType>::operator *() noexcept{
+	return *this->access();
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline Type& agm::InlinePtr<Type, Size, DeleterType>::operator *() const noexcept{
+	return *this->access();
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline agm::InlinePtr<Type, Size, DeleterType>& agm::InlinePtr<Type, Size, DeleterType>::operator =(agm::InlinePtr<Type, Size, DeleterType>&& ptr) noexcept{
+	if(this != &ptr){
+		//Through a temporary, as destroying the old object first could destroy ptr when the old object owns it
+		InlinePtr<Type, Size, DeleterType> taken(std::move(ptr));
+		free();
+		this->getDeleter() = std::move(taken.getDeleter());
+		take(taken);
+	}
+	return *this;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+template<typename OtherType>
+inline agm::InlinePtr<Type, Size, DeleterType>& agm::InlinePtr<Type, Size, DeleterType>::operator =(agm::UniquePtr<OtherType, DeleterType>&& ptr) noexcept{
+	InlinePtr<Type, Size, DeleterType> taken(std::move(ptr));
+	free();
+	this->getDeleter() = std::move(taken.getDeleter());
+	take(taken);
+	return *this;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline void agm::InlinePtr<Type, Size, DeleterType>::free() noexcept{
+	if(manager){
+		Telemetry::count<Type>(TelemetryOp::UniqueFree);
+		manager(storage, nullptr);
+		manager = nullptr;
+	} else if(this->isValid()){
+		Telemetry::count<Type>(TelemetryOp::UniqueFree);
+		if constexpr(IsDeferredDeleter<DeleterType>::value){
+			DeleterType::defer(&reclaim, this->get());
+		} else{
+			this->getDeleter()(this->get());
+		}
+	}
+	this->object = nullptr;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline void agm::InlinePtr<Type, Size, DeleterType>::take(agm::InlinePtr<Type, Size, DeleterType>& ptr) noexcept{
+	if(ptr.manager){
+		this->object = ptr.manager(ptr.storage, storage);
+		manager = ptr.manager;
+		ptr.manager = nullptr;
+	} else{
+		this->object = ptr.object;
+	}
+	ptr.object = nullptr;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+template<typename OtherType>
+inline void agm::InlinePtr<Type, Size, DeleterType>::take(agm::UniquePtr<OtherType, DeleterType>& ptr) noexcept{
+	if constexpr(fitsInline<OtherType> && std::is_final<OtherType>::value){
+		if(ptr.object){
+			OtherType* moved = new(storage) OtherType(std::move(*ptr.object));
+			this->object = moved;
+			manager = &manage<OtherType>;
+			//ptr's deleter frees the moved from object
+			ptr.reset();
+		}
+	} else{
+		static_assert(std::is_same<std::remove_cv_t<OtherType>, std::remove_cv_t<Type>>::value || std::has_virtual_destructor<Type>::value, "The heap object is deleted through Type, which needs a virtual destructor");
+
+		this->object = ptr.object;
+		this->getDeleter() = std::move(ptr.getDeleter());
+		ptr.object = nullptr;
+	}
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+template<typename OtherType>
+inline Type* agm::InlinePtr<Type, Size, DeleterType>::manage(void* source, void* destination) noexcept{
+	OtherType* object = std::launder(reinterpret_cast<OtherType*>(source));
+	Type* moved = nullptr;
+	if(destination){
+		moved = new(destination) OtherType(std::move(*object));
+	}
+	object->~OtherType();
+	return moved;
+}
+
+template<typename Type, std::size_t Size, typename DeleterType>
+inline void agm::InlinePtr<Type, Size, DeleterType>::reclaim(void* inObject) noexcept{
+	DeleterType()(static_cast<Type*>(inObject));
+}
+
+/////////HELPER FUNCTIONS
+template<typename Type, typename OtherType, std::size_t Size, typename... ArgTypes>
+inline agm::InlinePtr<Type, Size> agm::AGM_ABI_NAMESPACE::makeInline(ArgTypes&&... args){
+	InlinePtr<Type, Size> ptr;
+	ptr.template emplace<OtherType>(std::forward<ArgTypes>(args)...);
+	return ptr;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////LAZY SHARED
+	//Builds a shared object the first time it is asked for, from any number of threads. The first get() runs the factory
+	//under a lock, every call after that is a single acquire load returning the stored pointer, which doesn't change again
+	//until the LazyShared is destroyed. If the factory throws nothing is stored and the next get() tries again.
+	//warmUp() builds it on a background thread instead, and a get() that arrives while that is running waits for it
+	template<typename Type, typename CounterType = AtomicCounter>
+	class LazyShared{
+		static_assert(!std::is_same<CounterType, Counter>::value && !std::is_same<CounterType, StrongCounter>::value, "LazyShared hands the object to other threads, so it needs a thread safe counter");
+
+	public:
+		typedef std::function<SharedPtr<Type, DefaultDeleter, CounterType>()> FactoryType;
+
+		//VARIABLES
+	private:
+		std::atomic<bool> ready{ false };
+		SharedPtr<Type, DefaultDeleter, CounterType> value;
+
+		std::mutex lock;
+		FactoryType factory;
+		std::thread warmer;
+		//Guarded by lock, cleared by the warmer when it is done so a failed warm up can be started again
+		bool warming = false;
+
+		//FUNCTIONS
+	public:
+		//Default constructs the object with makeShared
+		LazyShared();
+		explicit LazyShared(FactoryType inFactory);
+
+		LazyShared(const LazyShared<Type, CounterType>& other) = delete;
+
+		//Waits for warmUp() to finish
+		~LazyShared();
+
+		//Copy the result to keep the object alive past the LazyShared
+		const SharedPtr<Type, DefaultDeleter, CounterType>& get();
+		WeakPtr<Type, DefaultDeleter, CounterType> getWeak();
+
+		bool isReady() const noexcept;
+
+		//Starts building the object on a background thread if it hasn't been built and isn't already being built.
+		//An exception from the factory is dropped there, so a failure is only reported later, when the next get() runs
+		//the factory again and it throws on that thread. warmUp() can also be called again to retry in the background
+		void warmUp();
+
+		LazyShared<Type, CounterType>& operator =(const LazyShared<Type, CounterType>& other) = delete;
+
+	private:
+		const SharedPtr<Type, DefaultDeleter, CounterType>& create();
+	};
+}
+}
+
+/////////INLINE INCLUDE
+#include "LazyShared.inl"
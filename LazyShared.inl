@@ -0,0 +1,69 @@
+/////////LAZY SHARED
+template<typename Type, typename CounterType>
+inline agm::LazyShared<Type, CounterType>::LazyShared()
+	: factory([](){ return makeShared<Type, CounterType>(); }){
+}
+
+template<typename Type, typename CounterType>
+inline agm::LazyShared<Type, CounterType>::LazyShared(FactoryType inFactory)
+	: factory(std::move(inFactory)){
+}
+
+template<typename Type, typename CounterType>
+inline agm::LazyShared<Type, CounterType>::~LazyShared(){
+	if(warmer.joinable()){
+		warmer.join();
+	}
+}
+
+template<typename Type, typename CounterType>
+inline const agm::SharedPtr<Type, agm::DefaultDeleter, CounterType>& agm::LazyShared<Type, CounterType>::get(){
+	if(ready.load(std::memory_order_acquire)){
+		return value;
+	}
+	return create();
+}
+
+template<typename Type, typename CounterType>
+inline agm::WeakPtr<Type, agm::DefaultDeleter, CounterType> agm::LazyShared<Type, CounterType>::getWeak(){
+	return WeakPtr<Type, DefaultDeleter, CounterType>(get());
+}
+
+template<typename Type, typename CounterType>
+inline bool agm::LazyShared<Type, CounterType>::isReady() const noexcept{
+	return ready.load(std::memory_order_acquire);
+}
+
+template<typename Type, typename CounterType>
+inline void agm::LazyShared<Type, CounterType>::warmUp(){
+	std::lock_guard<std::mutex> guard(lock);
+	if(ready.load(std::memory_order_relaxed) || warming){
+		return;
+	}
+	//A previous warm up that failed, it has already given up the lock for the last time so this won't wait on it
+	if(warmer.joinable()){
+		warmer.join();
+	}
+
+	warming = true;
+	warmer = std::thread([this](){
+		try{
+			create();
+		} catch(...){
+		}
+		std::lock_guard<std::mutex> guard(lock);
+		warming = false;
+	});
+}
+
+template<typename Type, typename CounterType>
+inline const agm::SharedPtr<Type, agm::DefaultDeleter, CounterType>& agm::LazyShared<Type, CounterType>::create(){
+	std::lock_guard<std::mutex> guard(lock);
+	if(!ready.load(std::memory_order_relaxed)){
+		value = factory();
+		//Whatever the factory captured is no longer needed
+		factory = nullptr;
+		ready.store(true, std::memory_order_release);
+	}
+	return value;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Ptr.h"
+
+#if defined(_WIN32)
+#error "MappedFile.h maps files with mmap, which is only available on POSIX systems"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////MAP HINT
+	//Passed on to madvise, the kernel is free to ignore them
+	enum class MapHint{
+		Normal,
+		//Read far ahead and drop pages soon after they have been read
+		Sequential,
+		//Don't read ahead, for lookups scattered across the file
+		Random,
+		//Start reading the range in now so the first accesses don't fault
+		WillNeed,
+	};
+
+	/////////UNMAP DELETER
+	//Unmaps the whole mapping, so pointers to any part of it can share the control block
+	struct UnmapDeleter{
+		void* base = nullptr;
+		std::size_t length = 0;
+
+		template<typename Type>
+		void operator ()(Type* ptr);
+	};
+
+	/////////MAPPED POINTER
+	//Read only view of a file mapped with MAP_SHARED, so its pages come straight from the page cache and are shared with
+	//every other process mapping the same file. Nothing is read until it is touched. Aliasing pointers to records in
+	//the file, e.g. SharedPtr<const Record, UnmapDeleter>(mapped, reinterpret_cast<const Record*>(mapped.get() + offset)),
+	//keep the whole mapping alive
+	template<typename CounterType = DefaultCounter>
+	using MappedPtr = SharedPtr<const std::byte[], UnmapDeleter, CounterType>;
+
+	/////////HELPER FUNCTIONS
+	//Maps the whole file. Returns an empty pointer if the file is empty or can't be opened or mapped, errno says why
+	template<typename CounterType = DefaultCounter>
+	MappedPtr<CounterType> mapShared(const char* path, MapHint hint = MapHint::Normal);
+	//Maps up to length bytes starting at offset, which doesn't have to be page aligned
+	template<typename CounterType = DefaultCounter>
+	MappedPtr<CounterType> mapShared(const char* path, std::size_t offset, std::size_t length, MapHint hint = MapHint::Normal);
+
+	//Advises part of an existing mapping, e.g. WillNeed on the next chunk a reader is about to reach. The range is widened
+	//to whole pages. Returns false if madvise failed
+	bool adviseMapped(const void* address, std::size_t length, MapHint hint);
+}
+}
+
+/////////INLINE INCLUDE
+#include "MappedFile.inl"
@@ -0,0 +1,76 @@
+/////////UNMAP DELETER
+template<typename Type>
+inline void agm::UnmapDeleter::operator ()(Type*){
+	::munmap(base, length);
+}
+
+/////////HELPER FUNCTIONS
+template<typename CounterType>
+inline agm::MappedPtr<CounterType> agm::AGM_ABI_NAMESPACE::mapShared(const char* path, MapHint hint){
+	return mapShared<CounterType>(path, 0, ~std::size_t(0), hint);
+}
+
+template<typename CounterType>
+inline agm::MappedPtr<CounterType> agm::AGM_ABI_NAMESPACE::mapShared(const char* path, std::size_t offset, std::size_t length, MapHint hint){
+	const int file = ::open(path, O_RDONLY | O_CLOEXEC);
+	if(file < 0){
+		return MappedPtr<CounterType>();
+	}
+
+	struct stat info;
+	if(::fstat(file, &info) != 0){
+		const int error = errno;
+		::close(file);
+		errno = error;
+		return MappedPtr<CounterType>();
+	}
+
+	const std::size_t fileSize = static_cast<std::size_t>(info.st_size);
+	if(offset >= fileSize || length == 0){
+		::close(file);
+		errno = EINVAL;
+		return MappedPtr<CounterType>();
+	}
+	length = std::min(length, fileSize - offset);
+
+	//mmap needs a page aligned offset, so map from the start of the page and point the result at offset
+	const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+	const std::size_t mapOffset = offset - offset % pageSize;
+	const std::size_t mapLength = length + (offset - mapOffset);
+
+	void* base = ::mmap(nullptr, mapLength, PROT_READ, MAP_SHARED, file, static_cast<off_t>(mapOffset));
+	const int error = errno;
+	//The mapping holds its own reference to the file
+	::close(file);
+	if(base == MAP_FAILED){
+		errno = error;
+		return MappedPtr<CounterType>();
+	}
+
+	const std::byte* start = static_cast<const std::byte*>(base) + (offset - mapOffset);
+	if(hint != MapHint::Normal){
+		adviseMapped(start, length, hint);
+	}
+
+	try{
+		return MappedPtr<CounterType>(start, length, UnmapDeleter{ base, mapLength });
+	} catch(...){
+		::munmap(base, mapLength);
+		throw;
+	}
+}
+
+inline bool agm::AGM_ABI_NAMESPACE::adviseMapped(const void* address, std::size_t length, MapHint hint){
+	int advice = MADV_NORMAL;
+	switch(hint){
+		case MapHint::Normal: advice = MADV_NORMAL; break;
+		case MapHint::Sequential: advice = MADV_SEQUENTIAL; break;
+		case MapHint::Random: advice = MADV_RANDOM; break;
+		case MapHint::WillNeed: advice = MADV_WILLNEED; break;
+	}
+
+	const std::uintptr_t pageSize = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+	const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(address) & ~(pageSize - 1);
+	const std::size_t span = length + static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(address) - start);
+	return ::madvise(reinterpret_cast<void*>(start), span, advice) == 0;
+}
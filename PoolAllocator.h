@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////FIXED POOL
+	//Hands out fixed size chunks carved from larger slabs. Freed chunks go on a free list to be
+	//reused and slabs are never given back, so a pool only ever grows to its peak usage
+	template<std::size_t ChunkSize, std::size_t ChunkAlign>
+	class FixedPool{
+		//VARIABLES
+	private:
+		union Chunk{
+			Chunk* next;
+			alignas(ChunkAlign) unsigned char storage[ChunkSize];
+		};
+
+		static constexpr std::size_t chunksPerSlab = 64;
+
+		Chunk* freeList = nullptr;
+
+		//Chunks can be freed from any thread when used with AtomicCounter
+		std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+		//FUNCTIONS
+	public:
+		static FixedPool<ChunkSize, ChunkAlign>& get();
+
+		void* allocate();
+		void deallocate(void* ptr);
+
+	private:
+		FixedPool() = default;
+
+		//Puts every chunk of a new slab on the free list, called with the lock held
+		void grow(Chunk* slab);
+	};
+
+	/////////POOL ALLOCATOR
+	//Standard allocator that serves single objects from the FixedPool for their size,
+	//pass it to allocateShared / allocateUnique to keep control blocks off the global heap
+	template<typename Type>
+	class PoolAllocator{
+		//FUNCTIONS
+	public:
+		typedef Type value_type;
+
+		PoolAllocator() = default;
+		template<typename OtherType> PoolAllocator(const PoolAllocator<OtherType>& other);
+
+		Type* allocate(std::size_t count);
+		void deallocate(Type* ptr, std::size_t count);
+	};
+
+	template<typename Type, typename OtherType>
+	bool operator ==(const PoolAllocator<Type>& lalloc, const PoolAllocator<OtherType>& ralloc);
+	template<typename Type, typename OtherType>
+	bool operator !=(const PoolAllocator<Type>& lalloc, const PoolAllocator<OtherType>& ralloc);
+}
+}
+
+/////////INLINE INCLUDE
+#include "PoolAllocator.inl"
@@ -0,0 +1,83 @@
+#include <new>
+
+/////////FIXED POOL
+template<std::size_t ChunkSize, std::size_t ChunkAlign>
+inline agm::FixedPool<ChunkSize, ChunkAlign>& agm::FixedPool<ChunkSize, ChunkAlign>::get(){
+	//Never destroyed so objects released during static destruction can still return their chunks
+	static FixedPool<ChunkSize, ChunkAlign>* pool = new FixedPool<ChunkSize, ChunkAlign>();
+	return *pool;
+}
+
+template<std::size_t ChunkSize, std::size_t ChunkAlign>
+inline void* agm::FixedPool<ChunkSize, ChunkAlign>::allocate(){
+	while(lock.test_and_set(std::memory_order_acquire)){}
+
+	if(!freeList){
+		//The slab is allocated without the lock held, so a throwing allocation can't leave the pool locked
+		lock.clear(std::memory_order_release);
+		Chunk* slab = new Chunk[chunksPerSlab];
+		while(lock.test_and_set(std::memory_order_acquire)){}
+		grow(slab);
+	}
+	Chunk* chunk = freeList;
+	freeList = chunk->next;
+
+	lock.clear(std::memory_order_release);
+	return chunk;
+}
+
+template<std::size_t ChunkSize, std::size_t ChunkAlign>
+inline void agm::FixedPool<ChunkSize, ChunkAlign>::deallocate(void* ptr){
+	Chunk* chunk = static_cast<Chunk*>(ptr);
+
+	while(lock.test_and_set(std::memory_order_acquire)){}
+
+	chunk->next = freeList;
+	freeList = chunk;
+
+	lock.clear(std::memory_order_release);
+}
+
+template<std::size_t ChunkSize, std::size_t ChunkAlign>
+inline void agm::FixedPool<ChunkSize, ChunkAlign>::grow(Chunk* slab){
+	for(std::size_t i = 0; i < chunksPerSlab - 1; ++i){
+		slab[i].next = &slab[i + 1];
+	}
+	slab[chunksPerSlab - 1].next = freeList;
+	freeList = slab;
+}
+
+/////////POOL ALLOCATOR
+template<typename Type>
+template<typename OtherType>
+inline agm::PoolAllocator<Type>::PoolAllocator(const agm::PoolAllocator<OtherType>&){
+}
+
+template<typename Type>
+inline Type* agm::PoolAllocator<Type>::allocate(std::size_t count){
+	if(count == 1){
+		return static_cast<Type*>(FixedPool<sizeof(Type), alignof(Type)>::get().allocate());
+	} else{
+		return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t(alignof(Type))));
+	}
+}
+
+template<typename Type>
+inline void agm::PoolAllocator<Type>::deallocate(Type* ptr, std::size_t count){
+	if(count == 1){
+		FixedPool<sizeof(Type), alignof(Type)>::get().deallocate(ptr);
+	} else{
+		::operator delete(ptr, std::align_val_t(alignof(Type)));
+	}
+}
+
+template<typename Type, typename OtherType>
+inline bool agm::AGM_ABI_NAMESPACE::operator ==(const agm::PoolAllocator<Type>&, const agm::PoolAllocator<OtherType>&){
+	//Every PoolAllocator shares the same pools
+	return true;
+}
+
+template<typename Type, typename OtherType>
+inline bool agm::AGM_ABI_NAMESPACE::operator !=(const agm::PoolAllocator<Type>& lalloc, const agm::PoolAllocator<OtherType>& ralloc){
+	return !(lalloc == ralloc);
+}
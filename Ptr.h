@@ -1,181 +1,821 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AGM_FUNCTION_NAME __FUNCSIG__
+#define AGM_RETURN_ADDRESS() _ReturnAddress()
+#define AGM_NOINLINE __declspec(noinline)
+#else
+#define AGM_FUNCTION_NAME __PRETTY_FUNCTION__
+#define AGM_RETURN_ADDRESS() __builtin_return_address(0)
+#define AGM_NOINLINE __attribute__((noinline))
+#endif
+
+//Settings that change inline functions are part of the namespace, so translation units built with different
+//settings never share definitions and passing agm types between them fails to link instead of misbehaving
+//Free functions are defined out of line as agm::AGM_ABI_NAMESPACE::name, GCC doesn't match agm::name to a function
+//template declared in the inline namespace
+#if defined(AGM_CHECKED_ACCESS) && defined(AGM_TELEMETRY)
+#define AGM_ABI_NAMESPACE checkedTelemetry
+#elif defined(AGM_CHECKED_ACCESS)
+#define AGM_ABI_NAMESPACE checked
+#elif defined(AGM_TELEMETRY)
+#define AGM_ABI_NAMESPACE uncheckedTelemetry
+#else
+#define AGM_ABI_NAMESPACE unchecked
+#endif
 
 namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
 	/////////COUNTER
+	//The strong references collectively hold one weak reference, so weakCount starts at 1
+	//and the control block can be deleted as soon as weakRelease() returns 0
 	class Counter{
 		//VARIALBES
 	private:
 		int strongCount = 0;
-		int weakCount = 0;
+		int weakCount = 1;
 
 		//FUNCTIONS
 	public:
-		inline void grab(){ ++strongCount; }
-		inline void weakGrab(){ ++weakCount; }
+		inline void grab() noexcept{ ++strongCount; }
+		inline void weakGrab() noexcept{ ++weakCount; }
 
-		inline int check(){ return strongCount; }
-		inline int fullCheck(){ return strongCount + weakCount; }
+		inline bool tryGrab() noexcept{ return strongCount > 0 ? (++strongCount, true) : false; }
 
-		inline int release(){ return --strongCount; }
-		inline int weakRelease(){ return --weakCount; }
+		inline int check() const noexcept{ return strongCount; }
+		inline int fullCheck() const noexcept{ return strongCount + weakCount; }
+
+		inline int release() noexcept{ return --strongCount; }
+		inline int weakRelease() noexcept{ return --weakCount; }
+	};
+
+	/////////ATOMIC COUNTER
+	//Thread safe counting policy. Increments are relaxed as a new reference can only be made from an
+	//existing one, decrements release so the last owner sees every write made through the other owners
+	class AtomicCounter{
+		//VARIALBES
+	private:
+		std::atomic<int> strongCount{ 0 };
+		std::atomic<int> weakCount{ 1 };
+
+		//FUNCTIONS
+	public:
+		inline void grab() noexcept{ strongCount.fetch_add(1, std::memory_order_relaxed); }
+		inline void weakGrab() noexcept{ weakCount.fetch_add(1, std::memory_order_relaxed); }
+
+		bool tryGrab() noexcept;
+
+		inline int check() const noexcept{ return strongCount.load(std::memory_order_acquire); }
+		inline int fullCheck() const noexcept{ return check() + weakCount.load(std::memory_order_acquire); }
+
+		int release() noexcept;
+		int weakRelease() noexcept;
+	};
+
+	/////////BIASED COUNTER
+	//Thread safe counting policy for objects that are mostly copied on the thread that made them. The owning thread
+	//counts its references in a plain int and every other thread uses an atomic count, which can go negative when
+	//references the owner made are released elsewhere. Once the owner's count reaches zero the two are merged and
+	//from then on it behaves like an AtomicCounter.
+	//If the owner gives all of its references away the object is queued on the owning thread instead, and merged (and
+	//destroyed, if nothing else holds it) the next time that thread releases a biased reference, calls
+	//mergeBiasedCounts() or exits. Until then a WeakPtr can still pin it, as it has not started being destroyed.
+	//The queue is linked through the counters themselves so releasing never allocates. Locking the registry is the only
+	//thing that can still fail, and as release is noexcept that terminates
+	class BiasedCounter{
+		//VARIALBES
+	private:
+		struct ThreadRecord{
+			std::uint64_t id;
+			//The objects queued on this thread, linked through nextPending and guarded by registryLock()
+			BiasedCounter* pending = nullptr;
+			std::atomic<bool> hasPending{ false };
+
+			ThreadRecord();
+			~ThreadRecord();
+		};
+
+		//Plain thread_locals so checking for the owner is a single load, the ThreadRecord fills them in
+		static constexpr std::uint64_t noThread = ~std::uint64_t(0);
+		static inline thread_local std::uint64_t localId = noThread;
+		static inline thread_local ThreadRecord* localRecord = nullptr;
+		static inline thread_local bool localExited = false;
+
+		//sharedCount holds the count of the other threads multiplied by countUnit, with the flags in the low bits
+		static constexpr int mergedFlag = 1;
+		static constexpr int queuedFlag = 2;
+		static constexpr int countUnit = 4;
+
+		std::atomic<std::uint64_t> ownerId{ 0 };
+		int biasedCount = 0;
+		std::atomic<int> sharedCount{ 0 };
+		std::atomic<int> weakCount{ 1 };
+		//Guarded by registryLock()
+		BiasedCounter* nextPending = nullptr;
+
+		//FUNCTIONS
+	public:
+		BiasedCounter();
+
+		void grab() noexcept;
+		inline void weakGrab() noexcept{ weakCount.fetch_add(1, std::memory_order_relaxed); }
+
+		bool tryGrab() noexcept;
+
+		int check() const noexcept;
+		int fullCheck() const noexcept;
+
+		int release() noexcept;
+		int weakRelease() noexcept;
+
+		//Merges every object queued on the calling thread
+		static void mergePending() noexcept;
+
+	private:
+		int sharedRelease() noexcept;
+		int queueRelease() noexcept;
+
+		//Folds the owner's count into the shared count and returns the new shared value
+		int merge(int sharedDelta) noexcept;
+
+		static void mergePending(ThreadRecord& record) noexcept;
+		static void reclaimMerged(BiasedCounter* counter) noexcept;
+
+		inline bool isOwner() const{ return ownerId.load(std::memory_order_relaxed) == localId; }
+
+		static inline int countOf(int value){ return (value & ~(countUnit - 1)) / countUnit; }
+
+		static void registerThread();
+		static std::mutex& registryLock();
+		static std::unordered_map<std::uint64_t, ThreadRecord*>& registry();
+	};
+
+	/////////STRONG COUNTER
+	//Counting policy for objects that are never observed through a WeakPtr. There is no weak count, so the control block
+	//is smaller and the object and the block are always destroyed together when the last strong reference goes.
+	//Making a WeakPtr to one is a compile error, as is anything built on WeakPtr (SharedFromThis, WeakCache, CycleCollector)
+	class StrongCounter{
+		//VARIALBES
+	private:
+		int strongCount = 0;
+
+		//FUNCTIONS
+	public:
+		inline void grab() noexcept{ ++strongCount; }
+
+		inline int check() const noexcept{ return strongCount; }
+		inline int fullCheck() const noexcept{ return strongCount; }
+
+		inline int release() noexcept{ return --strongCount; }
+		//Constant, so the check for remaining weak references folds away wherever the block is reclaimed
+		inline int weakRelease() noexcept{ return 0; }
+	};
+
+	/////////ATOMIC STRONG COUNTER
+	//Thread safe StrongCounter, ordered the same way as AtomicCounter
+	class AtomicStrongCounter{
+		//VARIALBES
+	private:
+		std::atomic<int> strongCount{ 0 };
+
+		//FUNCTIONS
+	public:
+		inline void grab() noexcept{ strongCount.fetch_add(1, std::memory_order_relaxed); }
+
+		inline int check() const noexcept{ return strongCount.load(std::memory_order_acquire); }
+		inline int fullCheck() const noexcept{ return check(); }
+
+		int release() noexcept;
+		inline int weakRelease() noexcept{ return 0; }
 	};
 
+	//Counters without a weak count, WeakPtr refuses to be made from pointers that use them
+	template<typename CounterType>
+	struct IsStrongOnly : std::false_type{
+	};
+	template<>
+	struct IsStrongOnly<StrongCounter> : std::true_type{
+	};
+	template<>
+	struct IsStrongOnly<AtomicStrongCounter> : std::true_type{
+	};
+
+	//Counters whose check() is the exact strong count. BiasedCounter only knows the object is alive until its counts are
+	//merged, so anything that does arithmetic with the count refuses it
+	template<typename CounterType>
+	struct HasExactCount : std::true_type{
+	};
+	template<>
+	struct HasExactCount<BiasedCounter> : std::false_type{
+	};
+
+#ifdef AGM_ATOMIC_COUNTER
+	typedef AtomicCounter DefaultCounter;
+#else
+	typedef Counter DefaultCounter;
+#endif
+
 	/////////DEFAULT DELETER
 	struct DefaultDeleter{
-		void operator ()(void* ptr){
+		template<typename Type>
+		void operator ()(Type* ptr){
 			delete ptr;
 		}
-		void operator ()(const void* ptr){
-			delete ptr;
+	};
+
+	/////////ARRAY DELETER
+	struct ArrayDeleter{
+		template<typename Type>
+		void operator ()(Type* ptr){
+			delete[] ptr;
 		}
 	};
 
+	//The array pointers swap DefaultDeleter for ArrayDeleter so UniquePtr<Type[]> / SharedPtr<Type[]> use delete[]
+	template<typename DeleterType>
+	struct ArrayDeleterType{
+		typedef DeleterType type;
+	};
+	template<>
+	struct ArrayDeleterType<DefaultDeleter>{
+		typedef ArrayDeleter type;
+	};
+
+	/////////DEFERRED DELETER
+	//A deleter with a static defer(reclaim, target) function is handed the last release of an object instead of
+	//it being destroyed on the releasing thread, it has to call reclaim(target) at some later point. See Reclaim.h
+	template<typename DeleterType, typename = void>
+	struct IsDeferredDeleter : std::false_type{
+	};
+	template<typename DeleterType>
+	struct IsDeferredDeleter<DeleterType, std::void_t<decltype(&DeleterType::defer)>> : std::true_type{
+	};
+
+	/////////COLLECTABLE
+	//Releasing a SharedPtr to a type that derives from CollectableNode without destroying it makes the object a candidate
+	//for the cycle collector, see CycleCollector.h. Incomplete types are never collectable
+	template<typename CounterType> class CollectableNode;
+	template<typename CounterType> class CycleCollector;
+	template<typename CounterType> class CycleTracer;
+
+	template<typename Type, typename CounterType, typename = void>
+	struct IsCollectable : std::false_type{
+	};
+	template<typename Type, typename CounterType>
+	struct IsCollectable<Type, CounterType, std::enable_if_t<(sizeof(Type) > 0)>> : std::is_base_of<CollectableNode<CounterType>, std::remove_cv_t<Type>>{
+	};
+
+	/////////DELETER STORAGE
+	//Stateless deleters are stored as an empty base so they don't add to the size of whatever holds them
+	template<typename DeleterType, bool = std::is_empty<DeleterType>::value && !std::is_final<DeleterType>::value>
+	class DeleterStorage : private DeleterType{
+		//FUNCTIONS
+	public:
+		DeleterStorage() = default;
+		explicit DeleterStorage(DeleterType inDeleter) : DeleterType(std::move(inDeleter)){}
+
+		inline DeleterType& getDeleter(){ return *this; }
+		inline const DeleterType& getDeleter() const{ return *this; }
+	};
+
+	template<typename DeleterType>
+	class DeleterStorage<DeleterType, false>{
+		//VARIABLES
+	private:
+		DeleterType deleter{};
+
+		//FUNCTIONS
+	public:
+		DeleterStorage() = default;
+		explicit DeleterStorage(DeleterType inDeleter) : deleter(std::move(inDeleter)){}
+
+		inline DeleterType& getDeleter(){ return deleter; }
+		inline const DeleterType& getDeleter() const{ return deleter; }
+	};
+
+	/////////ALLOCATOR STORAGE
+	//Same as DeleterStorage, stateless allocators take up no space in the control block
+	template<typename AllocatorType, bool = std::is_empty<AllocatorType>::value && !std::is_final<AllocatorType>::value>
+	class AllocatorStorage : private AllocatorType{
+		//FUNCTIONS
+	public:
+		explicit AllocatorStorage(const AllocatorType& inAllocator) : AllocatorType(inAllocator){}
+
+		inline AllocatorType& getAllocator(){ return *this; }
+	};
+
+	template<typename AllocatorType>
+	class AllocatorStorage<AllocatorType, false>{
+		//VARIABLES
+	private:
+		AllocatorType allocator;
+
+		//FUNCTIONS
+	public:
+		explicit AllocatorStorage(const AllocatorType& inAllocator) : allocator(inAllocator){}
+
+		inline AllocatorType& getAllocator(){ return allocator; }
+	};
+
+	/////////CONTROL BLOCKS
+	//Owns the object on behalf of the SharedPtrs / WeakPtrs pointing to it
+	template<typename CounterType>
+	class ControlBlock : public CounterType{
+		//FUNCTIONS
+	public:
+		virtual ~ControlBlock() = default;
+
+		virtual void destroyObject() = 0;
+		//Destroys the block and gives its memory back to the allocator it came from
+		virtual void destroyBlock() = 0;
+
+		//Destroys the object once the last strong reference is gone, and the block too if no weak references are left
+		static void reclaim(void* block);
+	};
+
+	//Control block for an object that was allocated separately (SharedPtr(Type*))
+	template<typename Type, typename DeleterType, typename CounterType, typename AllocatorType = std::allocator<std::remove_cv_t<Type>>>
+	class PointerBlock : public ControlBlock<CounterType>, private DeleterStorage<DeleterType>, private AllocatorStorage<AllocatorType>{
+		//VARIABLES
+	private:
+		Type* object = nullptr;
+
+		//FUNCTIONS
+	public:
+		PointerBlock(const AllocatorType& inAllocator, Type* inObject, DeleterType inDeleter);
+
+		virtual void destroyObject() override;
+		virtual void destroyBlock() override;
+	};
+
+	//Control block that stores the object next to the counts (makeShared / allocateShared)
+	template<typename Type, typename CounterType, typename AllocatorType = std::allocator<std::remove_cv_t<Type>>>
+	class InlineBlock : public ControlBlock<CounterType>, private AllocatorStorage<AllocatorType>{
+		//VARIABLES
+	private:
+		union{
+			Type object;
+		};
+
+		//FUNCTIONS
+	public:
+		template<typename... ArgTypes> explicit InlineBlock(const AllocatorType& inAllocator, ArgTypes&&... args);
+		~InlineBlock();
+
+		Type* get();
+
+		virtual void destroyObject() override;
+		virtual void destroyBlock() override;
+	};
+
+	//Allocates a control block through AllocatorType (rebound to the block)
+	template<typename BlockType, typename AllocatorType, typename... ArgTypes>
+	BlockType* createBlock(const AllocatorType& allocator, ArgTypes&&... args);
+
+	//Control block for makeSharedArray. The elements are placed directly after the block in the same allocation
+	template<typename Type, typename CounterType>
+	class ArrayBlock : public ControlBlock<CounterType>{
+		//VARIABLES
+	private:
+		std::size_t count = 0;
+
+		//FUNCTIONS
+	public:
+		static ArrayBlock<Type, CounterType>* create(std::size_t inCount, bool valueInitialise);
+
+		Type* get();
+
+		virtual void destroyObject() override;
+		virtual void destroyBlock() override;
+
+	private:
+		explicit ArrayBlock(std::size_t inCount);
+
+		static constexpr std::size_t elementOffset();
+		static constexpr std::size_t allocationAlignment();
+	};
+
+	/////////ALLOCATOR DELETER
+	//Deleter for objects created with allocateUnique, destroys and frees the object through the allocator
+	template<typename AllocatorType>
+	class AllocatorDeleter : private AllocatorStorage<AllocatorType>{
+		typedef std::allocator_traits<AllocatorType> AllocatorTraits;
+
+		//FUNCTIONS
+	public:
+		AllocatorDeleter() : AllocatorStorage<AllocatorType>(AllocatorType()){}
+		explicit AllocatorDeleter(const AllocatorType& inAllocator) : AllocatorStorage<AllocatorType>(inAllocator){}
+
+		void operator ()(typename AllocatorTraits::value_type* ptr);
+	};
+
+	/////////TELEMETRY
+	//Defining AGM_TELEMETRY before including Ptr.h keeps counts for every type held by the pointers: how many objects are
+	//alive, the most there have been at once, how many control blocks have been made and how many reference count
+	//operations there have been. Control blocks that are still alive when the program exits are listed as leaks.
+	//Without it every hook is an empty inline function and the pointers are unchanged. Like AGM_CHECKED_ACCESS it is
+	//part of AGM_ABI_NAMESPACE, so it has to be defined the same way for the whole program
+#ifdef AGM_TELEMETRY
+	constexpr bool telemetryEnabled = true;
+#else
+	constexpr bool telemetryEnabled = false;
+#endif
+
+	enum class TelemetryOp{
+		Grab,
+		Release,
+		WeakGrab,
+		WeakRelease,
+		UniqueFree,
+		Count,
+	};
+
+	struct TypeTelemetry{
+		char name[128];
+
+		std::atomic<std::int64_t> live{ 0 };
+		std::atomic<std::int64_t> peak{ 0 };
+		std::atomic<std::uint64_t> allocations{ 0 };
+
+		//Only sampled operations are counted, multiply by Telemetry::getSampleRate() for an estimate of the total
+		std::atomic<std::uint64_t> ops[static_cast<int>(TelemetryOp::Count)]{};
+
+		const TypeTelemetry* next = nullptr;
+
+		explicit TypeTelemetry(const char* signature);
+	};
+
+	class Telemetry{
+		//VARIABLES
+	private:
+		struct BlockRecord{
+			TypeTelemetry* type;
+			void (*counts)(const void* block, int& strong, int& weak);
+		};
+
+		struct CallSite{
+			TypeTelemetry* type;
+			std::uint64_t ops[static_cast<int>(TelemetryOp::Count)];
+		};
+
+		static inline std::atomic<std::uint32_t> sampleRate{ 1 };
+		static inline std::atomic<bool> callSiteTracking{ false };
+		static inline std::atomic<bool> leakReportAtExit{ true };
+		static inline std::atomic<const TypeTelemetry*> types{ nullptr };
+
+		static inline thread_local std::uint32_t sampleTick = 0;
+
+		//FUNCTIONS
+	public:
+		//Counts one in every rate reference count operations per thread, and only keeps the control blocks of one in
+		//every rate objects for the leak report. Live, peak and allocation counts are always exact
+		static void setSampleRate(std::uint32_t rate);
+		static std::uint32_t getSampleRate();
+
+		//Records the address every sampled operation was made from, report() lists the busiest ones
+		static void setCallSiteTracking(bool enabled);
+		static void setLeakReportAtExit(bool enabled);
+
+		template<typename Type> static TypeTelemetry& forType();
+		static const TypeTelemetry* getTypes();
+
+		static void report(std::FILE* out = stderr);
+		//Lists every tracked control block that hasn't been destroyed yet, returns how many there were
+		static std::size_t reportLeaks(std::FILE* out = stderr);
+
+		//Hooks for the control blocks and pointers
+		template<typename Type, typename CounterType> static void blockCreated(ControlBlock<CounterType>* block);
+		template<typename Type> static void objectDestroyed();
+		template<typename CounterType> static void blockDestroyed(ControlBlock<CounterType>* block);
+		template<typename Type> static void count(TelemetryOp op);
+
+	private:
+		static bool sample();
+		static bool isTracked(const void* block);
+
+		//Not inlined, so the return address is where the operation was made from
+		static void recordCallSite(TypeTelemetry& type, TelemetryOp op);
+
+		template<typename CounterType> static void countsOf(const void* block, int& strong, int& weak);
+
+		static TypeTelemetry& registerType(TypeTelemetry* type);
+		static void reportAtExit();
+
+		static std::mutex& registryLock();
+		static std::unordered_map<const void*, BlockRecord>& blocks();
+		static std::unordered_map<const void*, CallSite>& callSites();
+	};
+
+	/////////ACCESS CHECKS
+	//Defining AGM_CHECKED_ACCESS before including Ptr.h makes ->, * and [] stop the program when the pointer is empty,
+	//expired or out of range, printing the pointer type and the address it was dereferenced from. Without it they are
+	//a single load of the stored object. It also stops the program when an IntrusivePtr is made from an object that
+	//wasn't created by makeIntrusive. Define it the same way for the whole program, see AGM_ABI_NAMESPACE
+#ifdef AGM_CHECKED_ACCESS
+	constexpr bool checkedAccess = true;
+#else
+	constexpr bool checkedAccess = false;
+#endif
+
+	[[noreturn]] void accessFailure(const char* reason, const char* function);
+	//For pointers that are used in a way that can't work, rather than dereferenced
+	[[noreturn]] void usageFailure(const char* message, const char* function);
+
 	/////////POINTER TYPES
-	template<typename Type, typename DeleterType> class RefPtrBase;
-	template<typename Type, typename DeleterType> class SharedPtr;
-	template<typename Type, typename DeleterType> class WeakPtr;
+	template<typename Type, typename PtrType> class PtrBase;
+	template<typename Type, typename PtrType, typename CounterType> class RefPtrBase;
+	template<typename Type, typename DeleterType, typename CounterType> class SharedPtr;
+	template<typename Type, typename DeleterType, typename CounterType> class WeakPtr;
 	template<typename Type, typename DeleterType> class UniquePtr;
+	template<typename Type, typename CounterType> class IntrusivePtr;
+	template<typename Type, typename DeleterType, typename CounterType> class AtomicSharedPtr;
+	template<typename Type, typename CounterType> class HandlePool;
+	template<typename Type, typename CounterType> class CowPtr;
+	template<typename Type, std::size_t Size, typename DeleterType> class InlinePtr;
 
 	/////////POINTER BASE
-	template<typename Type, typename DeleterType = DefaultDeleter>
+	//PtrType is the derived pointer, isValid() and free() are dispatched to it statically so the pointers don't carry a vtable
+	template<typename Type, typename PtrType>
 	class PtrBase{
-		template<typename OtherType, typename DeleterType> friend class PtrBase;
+		template<typename OtherType, typename OtherPtrType> friend class PtrBase;
 
 		//VARIABLES
 	protected:
 		Type* object = nullptr;
 
-		DeleterType deleter;
-
 		//FUNCTIONS	
 	public:
-		virtual ~PtrBase() = default;
+		Type* get() const noexcept;
 
-		Type* get() const;
+		bool isValid() const noexcept;
 
-		virtual bool isValid() const;
+		void reset() noexcept;
 
-		void reset();
-
-		explicit operator bool() const;
+		explicit operator bool() const noexcept;
 
 	protected:
-		virtual void free() = 0;
+		const PtrType& self() const noexcept;
+		PtrType& self() noexcept;
+
+		//The object for ->, * and [], see AGM_CHECKED_ACCESS
+		Type* access() const noexcept;
 	};
 
 	/////////REFERENCE POINTER BASE
-	template<typename Type, typename DeleterType = DefaultDeleter>
-	class RefPtrBase : public PtrBase<Type, DeleterType>{
-		template<typename OtherType, typename DeleterType> friend class RefPtrBase;
+	template<typename Type, typename PtrType, typename CounterType>
+	class RefPtrBase : public PtrBase<Type, PtrType>{
+		template<typename OtherType, typename OtherPtrType, typename OtherCounterType> friend class RefPtrBase;
 
 		//VARIABLES
 	protected:
-		Counter* ref = nullptr;
+		ControlBlock<CounterType>* ref = nullptr;
 
 		//FUNCTIONS	
 	public:
-		virtual ~RefPtrBase() = default;
+		bool isValid() const noexcept;
 
-		virtual bool isValid() const override;
+		//Orders and hashes by control block instead of by object, so aliased pointers to the same owner are equivalent
+		//and a WeakPtr keeps its place in a container after the object has been destroyed
+		template<typename OtherType, typename OtherPtrType> bool ownerBefore(const RefPtrBase<OtherType, OtherPtrType, CounterType>& ptr) const noexcept;
+		template<typename OtherType, typename OtherPtrType> bool ownerEquals(const RefPtrBase<OtherType, OtherPtrType, CounterType>& ptr) const noexcept;
+		std::size_t ownerHash() const noexcept;
 	};
 
 	/////////SHARED POINTER
-	template<typename Type, typename DeleterType = DefaultDeleter>
-	class SharedPtr : public RefPtrBase<Type, DeleterType>{
-		template<typename OtherType, typename DeleterType> friend class SharedPtr;
-
-		template<typename Type, typename DeleterType> friend class WeakPtr;
-		template<typename OtherType, typename DeleterType> friend class WeakPtr;
-
-		template<typename Type> friend class SharedFromThis;
-		template<typename OtherType> friend class SharedFromThis;
+	template<typename Type, typename DeleterType = DefaultDeleter, typename CounterType = DefaultCounter>
+	class SharedPtr : public RefPtrBase<Type, SharedPtr<Type, DeleterType, CounterType>, CounterType>{
+		friend class PtrBase<Type, SharedPtr<Type, DeleterType, CounterType>>;
+		template<typename OtherType, typename OtherDeleterType, typename OtherCounterType> friend class SharedPtr;
+		template<typename OtherType, typename OtherDeleterType, typename OtherCounterType> friend class WeakPtr;
+		template<typename OtherType, typename OtherCounterType> friend class SharedFromThis;
+		template<typename OtherType, typename OtherCounterType> friend class IntrusivePtr;
+		template<typename OtherType, typename OtherDeleterType, typename OtherCounterType> friend class AtomicSharedPtr;
+		template<typename OtherType, typename OtherCounterType> friend class HandlePool;
+		template<typename OtherCounterType> friend class CycleTracer;
+		template<typename OtherType, typename OtherCounterType> friend class CowPtr;
+
+		template<typename OtherType, typename OtherCounterType, typename AllocatorType, typename... ArgTypes>
+		friend SharedPtr<OtherType, DefaultDeleter, OtherCounterType> allocateShared(const AllocatorType& allocator, ArgTypes&&... args);
 
 		//FUNCTIONS
 	public:
-		explicit SharedPtr() = default;
+		explicit constexpr SharedPtr() noexcept = default;
 		explicit SharedPtr(Type* inObject);
+		SharedPtr(Type* inObject, DeleterType inDeleter);
+		template<typename AllocatorType> SharedPtr(Type* inObject, DeleterType inDeleter, const AllocatorType& allocator);
+
+		SharedPtr(const SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept;
+		SharedPtr(SharedPtr<Type, DeleterType, CounterType>&& ptr) noexcept;
+
+		SharedPtr(const WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept;
 
-		SharedPtr(const SharedPtr<Type, DeleterType>& ptr);
-		SharedPtr(const SharedPtr<Type, DeleterType>&& ptr);
+		template<typename OtherType> SharedPtr(const SharedPtr<OtherType, DeleterType, CounterType>& ptr) noexcept;
+		template<typename OtherType> SharedPtr(SharedPtr<OtherType, DeleterType, CounterType>&& ptr) noexcept;
 
-		SharedPtr(const WeakPtr<Type, DeleterType>& ptr);
-		SharedPtr(const WeakPtr<Type, DeleterType>&& ptr);
+		template<typename OtherType> SharedPtr(const WeakPtr<OtherType, DeleterType, CounterType>& ptr) noexcept;
 
-		template<typename OtherType> SharedPtr(const SharedPtr<OtherType, DeleterType>& ptr);
-		template<typename OtherType> SharedPtr(const SharedPtr<OtherType, DeleterType>&& ptr);
+		template <typename OtherType> SharedPtr(const SharedPtr<OtherType, DeleterType, CounterType>& ptr, Type* obj) noexcept;
+		template <typename OtherType> SharedPtr(SharedPtr<OtherType, DeleterType, CounterType>&& ptr, Type* obj) noexcept;
 
-		template<typename OtherType> SharedPtr(const WeakPtr<OtherType, DeleterType>& ptr);
-		template<typename OtherType> SharedPtr(const WeakPtr<OtherType, DeleterType>&& ptr);
+		~SharedPtr() noexcept;
 
-		template <typename OtherType> SharedPtr(const SharedPtr<OtherType, DeleterType>& ptr, Type* obj);
+		//A strong reference keeps the count above zero, so this only looks at the control block in checked builds
+		bool isValid() const noexcept;
 
-		~SharedPtr();
+		Type* operator ->() noexcept;
+		Type* operator ->() const noexcept;
 
-		Type* operator ->();
-		Type* operator ->() const;
+		Type& operator *() noexcept;
+		Type& operator *() const noexcept;
 
-		Type& operator *();
-		Type& operator *() const;
+		SharedPtr<Type, DeleterType, CounterType>& operator =(Type* inObject);
 
-		SharedPtr<Type, DeleterType>& operator =(Type* inObject);
+		SharedPtr<Type, DeleterType, CounterType>& operator =(const SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept;
+		SharedPtr<Type, DeleterType, CounterType>& operator =(SharedPtr<Type, DeleterType, CounterType>&& ptr) noexcept;
 
-		SharedPtr<Type, DeleterType>& operator =(const SharedPtr<Type, DeleterType>& ptr);
-		SharedPtr<Type, DeleterType>& operator =(const SharedPtr<Type, DeleterType>&& ptr);
+		SharedPtr<Type, DeleterType, CounterType>& operator =(const WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept;
 
-		SharedPtr<Type, DeleterType>& operator =(const WeakPtr<Type, DeleterType>& ptr);
-		SharedPtr<Type, DeleterType>& operator =(const WeakPtr<Type, DeleterType>&& ptr);
+		void swap(SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept;
 
 	protected:
-		virtual void free() override;
+		void free() noexcept;
 
 	private:
-		void init(Type* inObject, Counter* inRef = nullptr);
+		void init(Type* inObject, ControlBlock<CounterType>* inRef = nullptr);
+		void initBlock(Type* inObject, ControlBlock<CounterType>* inRef) noexcept;
+		void initPinned(Type* inObject, ControlBlock<CounterType>* inRef) noexcept;
 	};
 
-	/////////WEAK POINTER
-	template<typename Type, typename DeleterType = DefaultDeleter>
-	class WeakPtr : public RefPtrBase<Type, DeleterType>{
-		template<typename OtherType, typename DeleterType> friend class WeakPtr;
+	/////////SHARED ARRAY POINTER
+	template<typename Type, typename DeleterType, typename CounterType>
+	class SharedPtr<Type[], DeleterType, CounterType> : public RefPtrBase<Type, SharedPtr<Type[], DeleterType, CounterType>, CounterType>{
+		friend class PtrBase<Type, SharedPtr<Type[], DeleterType, CounterType>>;
+		//So a single element pointer can alias into the array, see SharedBuffer
+		template<typename OtherType, typename OtherDeleterType, typename OtherCounterType> friend class SharedPtr;
 
-		template<typename Type, typename DeleterType> friend class SharedPtr;
-		template<typename OtherType, typename DeleterType> friend class SharedPtr;
+		template<typename OtherType, typename OtherCounterType>
+		friend SharedPtr<OtherType[], DefaultDeleter, OtherCounterType> makeSharedArray(std::size_t count);
+		template<typename OtherType, typename OtherCounterType>
+		friend SharedPtr<OtherType[], DefaultDeleter, OtherCounterType> makeSharedArrayUninitialised(std::size_t count);
 
-		template<typename Type> friend class SharedFromThis;
-		template<typename OtherType> friend class SharedFromThis;
+		typedef typename ArrayDeleterType<DeleterType>::type ElementDeleterType;
+
+		//VARIABLES
+	private:
+		std::size_t count = 0;
 
 		//FUNCTIONS
 	public:
-		explicit WeakPtr() = default;
+		explicit constexpr SharedPtr() noexcept = default;
+		SharedPtr(Type* inObject, std::size_t inCount);
+		SharedPtr(Type* inObject, std::size_t inCount, ElementDeleterType inDeleter);
+
+		SharedPtr(const SharedPtr<Type[], DeleterType, CounterType>& ptr) noexcept;
+		SharedPtr(SharedPtr<Type[], DeleterType, CounterType>&& ptr) noexcept;
+
+		~SharedPtr() noexcept;
 
-		WeakPtr(const WeakPtr<Type, DeleterType>& ptr);
-		WeakPtr(const WeakPtr<Type, DeleterType>&& ptr);
+		bool isValid() const noexcept;
 
-		WeakPtr(const SharedPtr<Type, DeleterType>& ptr);
-		WeakPtr(const SharedPtr<Type, DeleterType>&& ptr);
+		Type& operator [](std::size_t index) const noexcept;
 
-		template<typename OtherType> WeakPtr(const WeakPtr<OtherType, DeleterType>& ptr);
-		template<typename OtherType> WeakPtr(const WeakPtr<OtherType, DeleterType>&& ptr);
+		std::size_t size() const noexcept;
 
-		template<typename OtherType> WeakPtr(const SharedPtr<OtherType, DeleterType>& ptr);
-		template<typename OtherType> WeakPtr(const SharedPtr<OtherType, DeleterType>&& ptr);
+		SharedPtr<Type[], DeleterType, CounterType>& operator =(const SharedPtr<Type[], DeleterType, CounterType>& ptr) noexcept;
+		SharedPtr<Type[], DeleterType, CounterType>& operator =(SharedPtr<Type[], DeleterType, CounterType>&& ptr) noexcept;
 
-		~WeakPtr();
+		void swap(SharedPtr<Type[], DeleterType, CounterType>& ptr) noexcept;
 
-		SharedPtr<Type, DeleterType> pin();
+	protected:
+		void free() noexcept;
+
+	private:
+		void init(Type* inObject, ControlBlock<CounterType>* inRef, std::size_t inCount);
+	};
+
+	/////////WEAK POINTER
+	template<typename Type, typename DeleterType = DefaultDeleter, typename CounterType = DefaultCounter>
+	class WeakPtr : public RefPtrBase<Type, WeakPtr<Type, DeleterType, CounterType>, CounterType>{
+		friend class PtrBase<Type, WeakPtr<Type, DeleterType, CounterType>>;
+		template<typename OtherType, typename OtherDeleterType, typename OtherCounterType> friend class WeakPtr;
+		template<typename OtherType, typename OtherDeleterType, typename OtherCounterType> friend class SharedPtr;
+		template<typename OtherType, typename OtherCounterType> friend class SharedFromThis;
+		template<typename OtherType, typename OtherCounterType> friend class IntrusivePtr;
+
+		//FUNCTIONS
+	public:
+		explicit constexpr WeakPtr() noexcept = default;
 
-		WeakPtr<Type, DeleterType>& operator =(const WeakPtr<Type, DeleterType>& ptr);
-		WeakPtr<Type, DeleterType>& operator =(const WeakPtr<Type, DeleterType>&& ptr);
+		WeakPtr(const WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept;
+		WeakPtr(WeakPtr<Type, DeleterType, CounterType>&& ptr) noexcept;
 
-		WeakPtr<Type, DeleterType>& operator =(const SharedPtr<Type, DeleterType>& ptr);
-		WeakPtr<Type, DeleterType>& operator =(const SharedPtr<Type, DeleterType>&& ptr);
+		WeakPtr(const SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept;
+
+		template<typename OtherType> WeakPtr(const WeakPtr<OtherType, DeleterType, CounterType>& ptr) noexcept;
+		template<typename OtherType> WeakPtr(WeakPtr<OtherType, DeleterType, CounterType>&& ptr) noexcept;
+
+		template<typename OtherType> WeakPtr(const SharedPtr<OtherType, DeleterType, CounterType>& ptr) noexcept;
+
+		template<typename OtherType> WeakPtr(const WeakPtr<OtherType, DeleterType, CounterType>& ptr, Type* obj) noexcept;
+		template<typename OtherType> WeakPtr(WeakPtr<OtherType, DeleterType, CounterType>&& ptr, Type* obj) noexcept;
+
+		~WeakPtr() noexcept;
+
+		SharedPtr<Type, DeleterType, CounterType> pin() noexcept;
+
+		//Does not keep the object alive, pin() first if it could be released while it is being used.
+		//Always checks for expiry, like get()
+		Type* operator ->() const noexcept;
+
+		WeakPtr<Type, DeleterType, CounterType>& operator =(const WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept;
+		WeakPtr<Type, DeleterType, CounterType>& operator =(WeakPtr<Type, DeleterType, CounterType>&& ptr) noexcept;
+
+		WeakPtr<Type, DeleterType, CounterType>& operator =(const SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept;
+
+		void swap(WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept;
 
 	protected:
-		virtual void free() override;
+		void free() noexcept;
+
+	private:
+		void init(Type* inObject, ControlBlock<CounterType>* inRef) noexcept;
+	};
+
+	/////////ATOMIC SHARED POINTER
+	//Holds a SharedPtr that can be loaded and replaced from any thread without a lock. Each stored value lives in a
+	//Snapshot, and the top 16 bits of the packed word count the loads that are currently reading it (split reference
+	//counting). A reader bumps that local count, copies the SharedPtr out and then gives the count back - or, if a writer
+	//has replaced the snapshot in the meantime, releases one of the holds the writer moved onto the snapshot instead.
+	//Pointers have to fit in the low 48 bits, which holds for user space on x86-64 and AArch64
+	template<typename Type, typename DeleterType = DefaultDeleter, typename CounterType = AtomicCounter>
+	class AtomicSharedPtr{
+		static_assert(std::is_same<CounterType, AtomicCounter>::value, "AtomicSharedPtr can only hold pointers that use an AtomicCounter");
+
+		//VARIABLES
+	private:
+		struct Snapshot{
+			SharedPtr<Type, DeleterType, CounterType> value;
+			std::atomic<std::int64_t> holds{ 0 };
+		};
+
+		static constexpr int countShift = 48;
+		static constexpr std::uint64_t countUnit = std::uint64_t(1) << countShift;
+		static constexpr std::uint64_t pointerMask = countUnit - 1;
+
+		mutable std::atomic<std::uint64_t> packed{ 0 };
+
+		//FUNCTIONS
+	public:
+		AtomicSharedPtr() = default;
+		AtomicSharedPtr(SharedPtr<Type, DeleterType, CounterType> ptr);
+
+		AtomicSharedPtr(const AtomicSharedPtr<Type, DeleterType, CounterType>& ptr) = delete;
+
+		~AtomicSharedPtr();
+
+		SharedPtr<Type, DeleterType, CounterType> load() const;
+		WeakPtr<Type, DeleterType, CounterType> loadWeak() const;
+
+		void store(SharedPtr<Type, DeleterType, CounterType> ptr);
+		SharedPtr<Type, DeleterType, CounterType> exchange(SharedPtr<Type, DeleterType, CounterType> ptr);
+
+		//If the held pointer shares both object and control block with expected it is replaced with desired,
+		//otherwise expected is updated to the held pointer
+		bool compareExchange(SharedPtr<Type, DeleterType, CounterType>& expected, SharedPtr<Type, DeleterType, CounterType> desired);
+
+		bool isLockFree() const;
+
+		operator SharedPtr<Type, DeleterType, CounterType>() const;
+
+		AtomicSharedPtr<Type, DeleterType, CounterType>& operator =(const AtomicSharedPtr<Type, DeleterType, CounterType>& ptr) = delete;
+		AtomicSharedPtr<Type, DeleterType, CounterType>& operator =(SharedPtr<Type, DeleterType, CounterType> ptr);
 
 	private:
-		void init(Type* inObject, Counter* inRef);
+		Snapshot* acquire() const;
+		void release(Snapshot* snapshot) const;
+
+		static std::uint64_t createSnapshot(SharedPtr<Type, DeleterType, CounterType>&& ptr);
+		static void retire(std::uint64_t oldPacked);
+		static void dropHold(Snapshot* snapshot);
+		static Snapshot* toSnapshot(std::uint64_t value);
 	};
 
 	/////////SHARED FROM THIS
@@ -184,76 +824,348 @@ namespace agm{
 	template<typename T>
 	struct hasSharedFromThisType<T, std::void_t<typename T::SharedFromThisType>> : std::true_type{};
 
-	template<typename Type>
+	template<typename Type, typename DeleterType, typename CounterType, std::enable_if_t<hasSharedFromThisType<Type>::value, int> = 0>
+	void enable(Type* ptr, SharedPtr<Type, DeleterType, CounterType>* shptr);
+	void enable(...);
+
+	template<typename Type, typename CounterType = DefaultCounter>
 	class SharedFromThis{
+	public:
 		typedef Type SharedFromThisType;
 
 		//VARIABLES
 	private:
-		WeakPtr<Type> weakThis;
+		WeakPtr<Type, DefaultDeleter, CounterType> weakThis;
 
 		//FUNCTIONS
 	public:
-		WeakPtr<Type> getWeakThis() const;
-		SharedPtr<Type> getSharedThis() const;
+		WeakPtr<Type, DefaultDeleter, CounterType> getWeakThis() const noexcept;
+		SharedPtr<Type, DefaultDeleter, CounterType> getSharedThis() const noexcept;
 
-		template<typename OtherType> WeakPtr<OtherType> getWeakThis() const;
-		template<typename OtherType> SharedPtr<OtherType> getSharedThis() const;
+		template<typename OtherType> WeakPtr<OtherType, DefaultDeleter, CounterType> getWeakThis() const noexcept;
+		template<typename OtherType> SharedPtr<OtherType, DefaultDeleter, CounterType> getSharedThis() const noexcept;
 
 	private:
-		template<typename Type, std::enable_if_t<hasSharedFromThisType<Type>::value, int> = 0>
-		friend void enable(Type* ptr, SharedPtr<Type>* shptr);
+		template<typename OtherType, typename DeleterType, typename OtherCounterType, std::enable_if_t<hasSharedFromThisType<OtherType>::value, int>>
+		friend void enable(OtherType* ptr, SharedPtr<OtherType, DeleterType, OtherCounterType>* shptr);
 		friend void enable(...);
 
-		template<typename PtrType>
-		void doEnable(Type* ptr, SharedPtr<PtrType>* shptr);
+		template<typename PtrType, typename DeleterType>
+		void doEnable(Type* ptr, SharedPtr<PtrType, DeleterType, CounterType>* shptr);
+	};
+
+	/////////INTRUSIVE BLOCK
+	//Control block for makeIntrusive. The object is placed directly after the block in the same allocation,
+	//so the counts sit right in front of the object and either can be found from the other with a fixed offset.
+	//The offset is the size of the block whatever the type of the object, so a pointer to a base class finds the same
+	//counts. The counts are not part of the object, so WeakPtrs can still read them after the object is destroyed
+	template<typename Type, typename CounterType>
+	class IntrusiveBlock : public ControlBlock<CounterType>{
+		//FUNCTIONS
+	public:
+		template<typename... ArgTypes> static IntrusiveBlock<Type, CounterType>* create(ArgTypes&&... args);
+
+		Type* get();
+
+		virtual void destroyObject() override;
+		virtual void destroyBlock() override;
+
+	private:
+		static constexpr std::size_t objectOffset();
+		static constexpr std::size_t allocationAlignment();
+	};
+
+	/////////REF COUNTED
+	//Inherit from this to allow a type to be used with IntrusivePtr. Objects have to be created with makeIntrusive, which
+	//can also create types derived from Type. RefCounted has to be at the start of the object, which makeIntrusive checks
+	template<typename Type, typename CounterType = DefaultCounter>
+	class RefCounted{
+		template<typename OtherType, typename OtherCounterType> friend class IntrusiveBlock;
+		template<typename OtherType, typename OtherCounterType> friend class IntrusivePtr;
+
+	public:
+		typedef Type RefCountedType;
+		typedef CounterType RefCountedCounterType;
+
+		//FUNCTIONS
+	public:
+		//Only for objects created by makeIntrusive, like IntrusivePtr(Type*)
+		IntrusivePtr<Type, CounterType> getIntrusiveThis() const noexcept;
+		SharedPtr<Type, DefaultDeleter, CounterType> getSharedThis() const noexcept;
+		WeakPtr<Type, DefaultDeleter, CounterType> getWeakThis() const noexcept;
+
+	private:
+		ControlBlock<CounterType>* getBlock() const noexcept;
+
+		//Objects created by makeIntrusive that haven't been destroyed yet, only kept with AGM_CHECKED_ACCESS
+		static std::mutex& registryLock();
+		static std::unordered_set<const RefCounted<Type, CounterType>*>& liveObjects();
+	};
+
+	/////////INTRUSIVE POINTER
+	//Single pointer sized strong reference to a RefCounted object, the counts are found from the object itself
+	template<typename Type, typename CounterType = DefaultCounter>
+	class IntrusivePtr : public PtrBase<Type, IntrusivePtr<Type, CounterType>>{
+		friend class PtrBase<Type, IntrusivePtr<Type, CounterType>>;
+		template<typename OtherType, typename OtherCounterType> friend class IntrusivePtr;
+
+		//FUNCTIONS
+	public:
+		explicit constexpr IntrusivePtr() noexcept = default;
+		//inObject has to have been created by makeIntrusive, anything else is undefined behaviour once the count is
+		//released. Checked with AGM_CHECKED_ACCESS
+		explicit IntrusivePtr(Type* inObject) noexcept;
+
+		IntrusivePtr(const IntrusivePtr<Type, CounterType>& ptr) noexcept;
+		IntrusivePtr(IntrusivePtr<Type, CounterType>&& ptr) noexcept;
+
+		template<typename OtherType> IntrusivePtr(const IntrusivePtr<OtherType, CounterType>& ptr) noexcept;
+		template<typename OtherType> IntrusivePtr(IntrusivePtr<OtherType, CounterType>&& ptr) noexcept;
+
+		~IntrusivePtr() noexcept;
+
+		SharedPtr<Type, DefaultDeleter, CounterType> getShared() const noexcept;
+		WeakPtr<Type, DefaultDeleter, CounterType> getWeak() const noexcept;
+
+		Type* operator ->() const noexcept;
+		Type& operator *() const noexcept;
+
+		IntrusivePtr<Type, CounterType>& operator =(const IntrusivePtr<Type, CounterType>& ptr) noexcept;
+		IntrusivePtr<Type, CounterType>& operator =(IntrusivePtr<Type, CounterType>&& ptr) noexcept;
+
+		void swap(IntrusivePtr<Type, CounterType>& ptr) noexcept;
+
+	protected:
+		void free() noexcept;
+
+	private:
+		void init(Type* inObject) noexcept;
+
+		static ControlBlock<CounterType>* getBlock(Type* inObject) noexcept;
 	};
 
 	/////////UNIQUE POINTER
 	template<typename Type, typename DeleterType = DefaultDeleter>
-	class UniquePtr : public PtrBase<Type, DeleterType>{
-		template<typename OtherType, typename DeleterType> friend class UniquePtr;
+	class UniquePtr : public PtrBase<Type, UniquePtr<Type, DeleterType>>, private DeleterStorage<DeleterType>{
+		friend class PtrBase<Type, UniquePtr<Type, DeleterType>>;
+		template<typename OtherType, typename OtherDeleterType> friend class UniquePtr;
+		template<typename OtherType, std::size_t OtherSize, typename OtherDeleterType> friend class InlinePtr;
+
+		template<typename ReturnType, typename CurrentType, typename OtherDeleterType>
+		friend UniquePtr<ReturnType, OtherDeleterType> staticCast(UniquePtr<CurrentType, OtherDeleterType>&& ptr) noexcept;
+		template<typename ReturnType, typename CurrentType, typename OtherDeleterType>
+		friend UniquePtr<ReturnType, OtherDeleterType> dynamicCast(UniquePtr<CurrentType, OtherDeleterType>&& ptr) noexcept;
+		template<typename ReturnType, typename CurrentType, typename OtherDeleterType>
+		friend UniquePtr<ReturnType, OtherDeleterType> constCast(UniquePtr<CurrentType, OtherDeleterType>&& ptr) noexcept;
 
 		//FUNCTIONS
 	public:
-		explicit UniquePtr() = default;
-		explicit UniquePtr(Type* inObject);
+		explicit constexpr UniquePtr() noexcept = default;
+		explicit UniquePtr(Type* inObject) noexcept;
+		UniquePtr(Type* inObject, DeleterType inDeleter) noexcept;
+
+		UniquePtr(UniquePtr<Type, DeleterType>&& ptr) noexcept;
 
-		UniquePtr(UniquePtr<Type, DeleterType>&& ptr);
+		template<typename OtherType> UniquePtr(UniquePtr<OtherType, DeleterType>&& ptr) noexcept;
 
-		template<typename OtherType> UniquePtr(UniquePtr<OtherType, DeleterType>&& ptr);
+		~UniquePtr() noexcept;
 
-		~UniquePtr();
+		UniquePtr<Type, DeleterType> move() noexcept;
 
-		UniquePtr<Type, DeleterType> move();
+		using DeleterStorage<DeleterType>::getDeleter;
 
-		Type* operator ->();
-		Type* operator ->() const;
+		Type* operator ->() noexcept;
+		Type* operator ->() const noexcept;
 
-		Type& operator *();
-		Type& operator *() const;
+		Type& operator *() noexcept;
+		Type& operator *() const noexcept;
 
-		UniquePtr<Type, DeleterType>& operator =(UniquePtr<Type, DeleterType>&& ptr);
+		UniquePtr<Type, DeleterType>& operator =(UniquePtr<Type, DeleterType>&& ptr) noexcept;
 
 	protected:
-		virtual void free() override;
+		void free() noexcept;
+
+	private:
+		//Takes ownership (and the deleter) from ptr but points at obj, which the deleter is given instead. Only for the
+		//casts, as obj has to be the object ptr owns, seen as a type it can be deleted through
+		template<typename OtherType> UniquePtr(UniquePtr<OtherType, DeleterType>&& ptr, Type* obj) noexcept;
+
+		static void reclaim(void* inObject) noexcept;
+	};
+
+	/////////UNIQUE ARRAY POINTER
+	template<typename Type, typename DeleterType>
+	class UniquePtr<Type[], DeleterType> : public PtrBase<Type, UniquePtr<Type[], DeleterType>>, private DeleterStorage<typename ArrayDeleterType<DeleterType>::type>{
+		friend class PtrBase<Type, UniquePtr<Type[], DeleterType>>;
+
+		typedef typename ArrayDeleterType<DeleterType>::type ElementDeleterType;
+
+		//VARIABLES
+	private:
+		std::size_t count = 0;
+
+		//FUNCTIONS
+	public:
+		explicit constexpr UniquePtr() noexcept = default;
+		UniquePtr(Type* inObject, std::size_t inCount) noexcept;
+		UniquePtr(Type* inObject, std::size_t inCount, ElementDeleterType inDeleter) noexcept;
+
+		UniquePtr(UniquePtr<Type[], DeleterType>&& ptr) noexcept;
+
+		~UniquePtr() noexcept;
+
+		UniquePtr<Type[], DeleterType> move() noexcept;
+
+		using DeleterStorage<ElementDeleterType>::getDeleter;
+
+		Type& operator [](std::size_t index) const noexcept;
+
+		std::size_t size() const noexcept;
+
+		UniquePtr<Type[], DeleterType>& operator =(UniquePtr<Type[], DeleterType>&& ptr) noexcept;
+
+	protected:
+		void free() noexcept;
+
+	private:
+		static void reclaim(void* inObject) noexcept;
+	};
+
+	/////////TRIVIALLY RELOCATABLE
+	//Moving an object to a new address and abandoning the old one can be done with memcpy for these types (see PtrVector).
+	//None of the pointers store their own address, so they all qualify as long as their deleter does
+	template<typename Type>
+	struct IsTriviallyRelocatable : std::is_trivially_copyable<Type>{
+	};
+	template<typename Type, typename DeleterType, typename CounterType>
+	struct IsTriviallyRelocatable<SharedPtr<Type, DeleterType, CounterType>> : std::true_type{
+	};
+	template<typename Type, typename DeleterType, typename CounterType>
+	struct IsTriviallyRelocatable<WeakPtr<Type, DeleterType, CounterType>> : std::true_type{
+	};
+	template<typename Type, typename CounterType>
+	struct IsTriviallyRelocatable<IntrusivePtr<Type, CounterType>> : std::true_type{
+	};
+	template<typename Type, typename DeleterType>
+	struct IsTriviallyRelocatable<UniquePtr<Type, DeleterType>> : IsTriviallyRelocatable<DeleterType>{
+	};
+	template<typename Type, typename DeleterType>
+	struct IsTriviallyRelocatable<UniquePtr<Type[], DeleterType>> : IsTriviallyRelocatable<typename ArrayDeleterType<DeleterType>::type>{
+	};
+
+	/////////OWNER COMPARISON
+	//Function objects for keying containers by owner, e.g. std::map<WeakPtr<T>, V, agm::OwnerLess>
+	struct OwnerLess{
+		template<typename LeftType, typename RightType>
+		bool operator ()(const LeftType& lptr, const RightType& rptr) const noexcept;
+	};
+
+	struct OwnerEqual{
+		template<typename LeftType, typename RightType>
+		bool operator ()(const LeftType& lptr, const RightType& rptr) const noexcept;
+	};
+
+	struct OwnerHash{
+		template<typename PtrType>
+		std::size_t operator ()(const PtrType& ptr) const noexcept;
 	};
 
 	/////////HELPER FUNCTIONS
 	template<typename Type>
 	UniquePtr<Type> makeUnique(Type* object);
 
+	//Takes ownership of an object created with new. Not an overload of makeShared, as a Type constructible from a Type*
+	//would otherwise adopt the argument instead of being constructed from it
+	template<typename Type, typename CounterType = DefaultCounter>
+	SharedPtr<Type, DefaultDeleter, CounterType> adoptShared(Type* object);
+	template<typename Type, typename CounterType = DefaultCounter, typename... ArgTypes>
+	SharedPtr<Type, DefaultDeleter, CounterType> makeShared(ArgTypes&&... args);
+
 	template<typename Type>
-	SharedPtr<Type> makeShared(Type* object);
-
-	template<typename ReturnType, typename CurrentType>
-	SharedPtr<ReturnType> staticCast(const SharedPtr<CurrentType>& ptr);
-	template<typename ReturnType, typename CurrentType>
-	SharedPtr<ReturnType> dynamicCast(const SharedPtr<CurrentType>& ptr);
-	template<typename ReturnType, typename CurrentType>
-	SharedPtr<ReturnType> constCast(const SharedPtr<CurrentType>& ptr);
-	template<typename ReturnType, typename CurrentType>
-	SharedPtr<ReturnType> reinterpretCast(const SharedPtr<CurrentType>& ptr);
+	UniquePtr<Type[]> makeUniqueArray(std::size_t count);
+	template<typename Type>
+	UniquePtr<Type[]> makeUniqueArrayUninitialised(std::size_t count);
+
+	template<typename Type, typename CounterType = DefaultCounter>
+	SharedPtr<Type[], DefaultDeleter, CounterType> makeSharedArray(std::size_t count);
+	template<typename Type, typename CounterType = DefaultCounter>
+	SharedPtr<Type[], DefaultDeleter, CounterType> makeSharedArrayUninitialised(std::size_t count);
+
+	template<typename Type, typename CounterType = DefaultCounter, typename AllocatorType, typename... ArgTypes>
+	SharedPtr<Type, DefaultDeleter, CounterType> allocateShared(const AllocatorType& allocator, ArgTypes&&... args);
+	template<typename Type, typename AllocatorType, typename... ArgTypes>
+	UniquePtr<Type, AllocatorDeleter<typename std::allocator_traits<AllocatorType>::template rebind_alloc<Type>>> allocateUnique(const AllocatorType& allocator, ArgTypes&&... args);
+
+	template<typename Type, typename... ArgTypes>
+	IntrusivePtr<Type, typename Type::RefCountedCounterType> makeIntrusive(ArgTypes&&... args);
+
+	void mergeBiasedCounts() noexcept;
+
+	template<typename Type, typename DeleterType, typename CounterType>
+	void swap(SharedPtr<Type, DeleterType, CounterType>& lptr, SharedPtr<Type, DeleterType, CounterType>& rptr) noexcept;
+	template<typename Type, typename DeleterType, typename CounterType>
+	void swap(WeakPtr<Type, DeleterType, CounterType>& lptr, WeakPtr<Type, DeleterType, CounterType>& rptr) noexcept;
+	template<typename Type, typename CounterType>
+	void swap(IntrusivePtr<Type, CounterType>& lptr, IntrusivePtr<Type, CounterType>& rptr) noexcept;
+
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> staticCast(const SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> dynamicCast(const SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> constCast(const SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> reinterpretCast(const SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+
+	//The rvalue casts move the reference out of ptr instead of grabbing a new one. A failed dynamicCast leaves ptr untouched
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> staticCast(SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> dynamicCast(SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> constCast(SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	SharedPtr<ReturnType, DeleterType, CounterType> reinterpretCast(SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+
+	//dynamicCast has to look at the object, so it briefly pins it and returns an empty WeakPtr if it has expired
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> staticCast(const WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> dynamicCast(const WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> constCast(const WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> reinterpretCast(const WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept;
+
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> staticCast(WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> dynamicCast(WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> constCast(WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+	WeakPtr<ReturnType, DeleterType, CounterType> reinterpretCast(WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept;
+
+	//Casting a UniquePtr transfers ownership, so they only take rvalues. The result deletes the object through ReturnType,
+	//so staticCast and dynamicCast need ReturnType to have a virtual destructor, and there is no reinterpretCast
+	template<typename ReturnType, typename CurrentType, typename DeleterType>
+	UniquePtr<ReturnType, DeleterType> staticCast(UniquePtr<CurrentType, DeleterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType>
+	UniquePtr<ReturnType, DeleterType> dynamicCast(UniquePtr<CurrentType, DeleterType>&& ptr) noexcept;
+	template<typename ReturnType, typename CurrentType, typename DeleterType>
+	UniquePtr<ReturnType, DeleterType> constCast(UniquePtr<CurrentType, DeleterType>&& ptr) noexcept;
+
+	/////////SIZE CHECKS
+	static_assert(sizeof(UniquePtr<int>) == sizeof(int*), "UniquePtr with the default deleter should be a single pointer");
+	static_assert(sizeof(SharedPtr<int>) == 2 * sizeof(void*), "SharedPtr should be an object and a control block pointer");
+	static_assert(sizeof(WeakPtr<int>) == 2 * sizeof(void*), "WeakPtr should be an object and a control block pointer");
+	static_assert(sizeof(IntrusivePtr<int>) == sizeof(int*), "IntrusivePtr should be a single pointer");
+
+	static_assert(sizeof(InlineBlock<int, StrongCounter>) < sizeof(InlineBlock<int, Counter>), "Blocks without a weak count should be smaller");
+
+	static_assert(std::is_nothrow_move_constructible<SharedPtr<int>>::value && std::is_nothrow_move_constructible<UniquePtr<int>>::value, "Pointers should move, not copy, when a std::vector grows");
+	static_assert(IsTriviallyRelocatable<SharedPtr<int>>::value && IsTriviallyRelocatable<UniquePtr<int>>::value, "Pointers with stateless deleters should be trivially relocatable");
+}
 }
 
 /////////INLINE INCLUDE
@@ -261,61 +1173,73 @@ namespace agm{
 
 /////////COMPARISON OPERATORS
 //T == T
-template<typename T>
-inline bool operator ==(const agm::PtrBase<T>& lptr, const agm::PtrBase<T>& rptr){
+template<typename T, typename P, typename Q>
+inline bool operator ==(const agm::PtrBase<T, P>& lptr, const agm::PtrBase<T, Q>& rptr) noexcept{
 	return lptr.get() == rptr.get();
 }
-template<typename T>
-inline bool operator ==(const agm::PtrBase<T>& ptr, const T* object){
+template<typename T, typename P>
+inline bool operator ==(const agm::PtrBase<T, P>& ptr, const T* object) noexcept{
 	return ptr.get() == object;
 }
-template<typename T>
-inline bool operator ==(const agm::PtrBase<T>& ptr, const T& object){
-	return ptr.get() == *object;
+template<typename T, typename P>
+inline bool operator ==(const agm::PtrBase<T, P>& ptr, const T& object) noexcept{
+	return ptr.get() == &object;
 }
 
 //T != T
-template<typename T>
-inline bool operator !=(const agm::PtrBase<T>& lptr, const agm::PtrBase<T>& rptr){
+template<typename T, typename P, typename Q>
+inline bool operator !=(const agm::PtrBase<T, P>& lptr, const agm::PtrBase<T, Q>& rptr) noexcept{
 	return !(lptr == rptr);
 }
-template<typename T>
-inline bool operator !=(const agm::PtrBase<T>& ptr, const T* object){
+template<typename T, typename P>
+inline bool operator !=(const agm::PtrBase<T, P>& ptr, const T* object) noexcept{
 	return !(ptr == object);
 }
-template<typename T>
-inline bool operator !=(const agm::PtrBase<T>& ptr, const T& object){
+template<typename T, typename P>
+inline bool operator !=(const agm::PtrBase<T, P>& ptr, const T& object) noexcept{
 	return !(ptr == object);
 }
 
 //T == U
-template<typename T, typename U>
-inline bool operator ==(const agm::PtrBase<T>& lptr, const agm::PtrBase<U>& rptr){
+template<typename T, typename P, typename U, typename Q>
+inline bool operator ==(const agm::PtrBase<T, P>& lptr, const agm::PtrBase<U, Q>& rptr) noexcept{
 	return lptr.get() == rptr.get();
 }
-template<typename T, typename U>
-inline bool operator ==(const agm::PtrBase<T>& ptr, const U* object){
+template<typename T, typename P, typename U>
+inline bool operator ==(const agm::PtrBase<T, P>& ptr, const U* object) noexcept{
 	return ptr.get() == object;
 }
 
 //T != U
-template<typename T, typename U>
-inline bool operator !=(const agm::PtrBase<T>& lptr, const agm::PtrBase<U>& rptr){
+template<typename T, typename P, typename U, typename Q>
+inline bool operator !=(const agm::PtrBase<T, P>& lptr, const agm::PtrBase<U, Q>& rptr) noexcept{
 	return !(lptr == rptr);
 }
-template<typename T, typename U>
-inline bool operator !=(const agm::PtrBase<T>& ptr, const U* object){
+template<typename T, typename P, typename U>
+inline bool operator !=(const agm::PtrBase<T, P>& ptr, const U* object) noexcept{
 	return !(ptr == object);
 }
 
 //T == nullptr_t
-template<typename T>
-inline bool operator ==(const agm::PtrBase<T>& ptr, std::nullptr_t object){
+template<typename T, typename P>
+inline bool operator ==(const agm::PtrBase<T, P>& ptr, std::nullptr_t object) noexcept{
 	return ptr.get() == object;
 }
 
 //T != nullptr_t
-template<typename T>
-inline bool operator !=(const agm::PtrBase<T>& ptr, std::nullptr_t object){
+template<typename T, typename P>
+inline bool operator !=(const agm::PtrBase<T, P>& ptr, std::nullptr_t object) noexcept{
 	return !(ptr == object);
 }
+
+/////////HASHING
+//SharedPtr hashes by object to match operator ==. WeakPtr has no std::hash, as an expired WeakPtr has no object to
+//compare by, containers keyed by WeakPtr should use agm::OwnerHash and agm::OwnerEqual instead
+namespace std{
+	template<typename Type, typename DeleterType, typename CounterType>
+	struct hash<agm::SharedPtr<Type, DeleterType, CounterType>>{
+		std::size_t operator ()(const agm::SharedPtr<Type, DeleterType, CounterType>& ptr) const noexcept{
+			return std::hash<Type*>()(ptr.get());
+		}
+	};
+}
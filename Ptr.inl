@@ -1,489 +1,2059 @@
+/////////ATOMIC COUNTER
+inline bool agm::AtomicCounter::tryGrab() noexcept{
+	int count = strongCount.load(std::memory_order_relaxed);
+	while(count > 0){
+		if(strongCount.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed)){
+			return true;
+		}
+	}
+	return false;
+}
+
+inline int agm::AtomicCounter::release() noexcept{
+	const int count = strongCount.fetch_sub(1, std::memory_order_release) - 1;
+	if(count == 0){
+		//An acquire load rather than a fence, it orders the same way and thread sanitizer understands it
+		(void)strongCount.load(std::memory_order_acquire);
+	}
+	return count;
+}
+
+inline int agm::AtomicCounter::weakRelease() noexcept{
+	const int count = weakCount.fetch_sub(1, std::memory_order_release) - 1;
+	if(count == 0){
+		(void)weakCount.load(std::memory_order_acquire);
+	}
+	return count;
+}
+
+/////////ATOMIC STRONG COUNTER
+inline int agm::AtomicStrongCounter::release() noexcept{
+	const int count = strongCount.fetch_sub(1, std::memory_order_release) - 1;
+	if(count == 0){
+		//An acquire load rather than a fence, it orders the same way and thread sanitizer understands it
+		(void)strongCount.load(std::memory_order_acquire);
+	}
+	return count;
+}
+
+/////////BIASED COUNTER
+inline agm::BiasedCounter::BiasedCounter(){
+	if(localId == noThread){
+		registerThread();
+	}
+
+	//A thread that has already exited can't own anything, so the count starts out merged
+	if(localId != noThread){
+		ownerId.store(localId, std::memory_order_relaxed);
+	} else{
+		sharedCount.store(mergedFlag, std::memory_order_relaxed);
+	}
+}
+
+inline void agm::BiasedCounter::grab() noexcept{
+	if(isOwner()){
+		++biasedCount;
+	} else{
+		sharedCount.fetch_add(countUnit, std::memory_order_relaxed);
+	}
+}
+
+inline bool agm::BiasedCounter::tryGrab() noexcept{
+	//Nothing is destroyed before it has been merged, so an unmerged object can always be grabbed
+	if(isOwner()){
+		++biasedCount;
+		return true;
+	}
+
+	int current = sharedCount.load(std::memory_order_relaxed);
+	while(!(current & mergedFlag) || countOf(current) > 0){
+		if(sharedCount.compare_exchange_weak(current, current + countUnit, std::memory_order_acquire, std::memory_order_relaxed)){
+			return true;
+		}
+	}
+	return false;
+}
+
+inline int agm::BiasedCounter::check() const noexcept{
+	//The shared count alone doesn't say how many references there are until it is merged, but the object is alive until then
+	const int current = sharedCount.load(std::memory_order_acquire);
+	return (current & mergedFlag) ? countOf(current) : 1;
+}
+
+inline int agm::BiasedCounter::fullCheck() const noexcept{
+	return check() + weakCount.load(std::memory_order_acquire);
+}
+
+inline int agm::BiasedCounter::release() noexcept{
+	if(!isOwner()){
+		return sharedRelease();
+	}
+
+	int count = 1;
+	if(--biasedCount == 0){
+		const int merged = merge(0);
+		if(merged & queuedFlag){
+			//Another thread queued this on us while we still held references, it doesn't need merging again
+			std::lock_guard<std::mutex> guard(registryLock());
+			BiasedCounter** link = &localRecord->pending;
+			while(*link != this){
+				link = &(*link)->nextPending;
+			}
+			*link = nextPending;
+			nextPending = nullptr;
+			localRecord->hasPending.store(localRecord->pending != nullptr, std::memory_order_relaxed);
+		}
+		count = countOf(merged);
+	}
+
+	if(localRecord->hasPending.load(std::memory_order_acquire)){
+		mergePending(*localRecord);
+	}
+	return count;
+}
+
+inline int agm::BiasedCounter::weakRelease() noexcept{
+	const int count = weakCount.fetch_sub(1, std::memory_order_release) - 1;
+	if(count == 0){
+		(void)weakCount.load(std::memory_order_acquire);
+	}
+	return count;
+}
+
+inline void agm::BiasedCounter::mergePending() noexcept{
+	if(localRecord){
+		mergePending(*localRecord);
+	}
+}
+
+inline int agm::BiasedCounter::sharedRelease() noexcept{
+	int current = sharedCount.load(std::memory_order_relaxed);
+	while(true){
+		//Going below zero means the owner has to be told about it, which is the slow path
+		if(!(current & (mergedFlag | queuedFlag)) && countOf(current) < 1){
+			return queueRelease();
+		}
+		if(sharedCount.compare_exchange_weak(current, current - countUnit, std::memory_order_acq_rel, std::memory_order_relaxed)){
+			return (current & mergedFlag) ? countOf(current) - 1 : 1;
+		}
+	}
+}
+
+inline int agm::BiasedCounter::queueRelease() noexcept{
+	//The queued flag is only set while holding the lock, so the owner can't miss it when it merges
+	std::lock_guard<std::mutex> guard(registryLock());
+
+	int current = sharedCount.load(std::memory_order_relaxed);
+	while(true){
+		if((current & (mergedFlag | queuedFlag)) || countOf(current) >= 1){
+			if(sharedCount.compare_exchange_weak(current, current - countUnit, std::memory_order_acq_rel, std::memory_order_relaxed)){
+				return (current & mergedFlag) ? countOf(current) - 1 : 1;
+			}
+			continue;
+		}
+
+		auto owner = registry().find(ownerId.load(std::memory_order_relaxed));
+		if(owner == registry().end()){
+			//The owner has exited, so nothing else can touch its count
+			return countOf(merge(-1));
+		}
+
+		if(sharedCount.compare_exchange_weak(current, (current - countUnit) | queuedFlag, std::memory_order_acq_rel, std::memory_order_relaxed)){
+			nextPending = owner->second->pending;
+			owner->second->pending = this;
+			owner->second->hasPending.store(true, std::memory_order_release);
+			return 1;
+		}
+	}
+}
+
+inline int agm::BiasedCounter::merge(int sharedDelta) noexcept{
+	const int delta = (biasedCount + sharedDelta) * countUnit;
+	biasedCount = 0;
+	ownerId.store(0, std::memory_order_relaxed);
+
+	int current = sharedCount.load(std::memory_order_relaxed);
+	while(!sharedCount.compare_exchange_weak(current, (current + delta) | mergedFlag, std::memory_order_acq_rel, std::memory_order_relaxed)){
+	}
+	return (current + delta) | mergedFlag;
+}
+
+inline void agm::BiasedCounter::mergePending(ThreadRecord& record) noexcept{
+	//Taken off one at a time, as destroying one object can release the owner's last reference to another queued one,
+	//which then has to find itself on the queue
+	while(true){
+		BiasedCounter* counter;
+		{
+			std::lock_guard<std::mutex> guard(registryLock());
+			counter = record.pending;
+			if(!counter){
+				record.hasPending.store(false, std::memory_order_relaxed);
+				return;
+			}
+			record.pending = counter->nextPending;
+			counter->nextPending = nullptr;
+		}
+
+		if(countOf(counter->merge(0)) == 0){
+			reclaimMerged(counter);
+		}
+	}
+}
+
+inline void agm::BiasedCounter::reclaimMerged(BiasedCounter* counter) noexcept{
+	ControlBlock<BiasedCounter>::reclaim(static_cast<ControlBlock<BiasedCounter>*>(counter));
+}
+
+inline void agm::BiasedCounter::registerThread(){
+	if(!localExited){
+		static thread_local ThreadRecord record;
+	}
+}
+
+inline std::mutex& agm::BiasedCounter::registryLock(){
+	//Never destroyed so threads can still exit during static destruction
+	static std::mutex* lock = new std::mutex();
+	return *lock;
+}
+
+inline std::unordered_map<std::uint64_t, agm::BiasedCounter::ThreadRecord*>& agm::BiasedCounter::registry(){
+	static std::unordered_map<std::uint64_t, ThreadRecord*>* threads = new std::unordered_map<std::uint64_t, ThreadRecord*>();
+	return *threads;
+}
+
+inline agm::BiasedCounter::ThreadRecord::ThreadRecord(){
+	//Ids are never reused, so an object can't be mistaken as owned by a later thread
+	static std::atomic<std::uint64_t> nextId{ 1 };
+	id = nextId.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::lock_guard<std::mutex> guard(registryLock());
+		registry()[id] = this;
+	}
+
+	localId = id;
+	localRecord = this;
+}
+
+inline agm::BiasedCounter::ThreadRecord::~ThreadRecord(){
+	//Anything released from here on sees this thread as a non-owner
+	localExited = true;
+	localId = noThread;
+	localRecord = nullptr;
+
+	{
+		std::lock_guard<std::mutex> guard(registryLock());
+		registry().erase(id);
+	}
+	mergePending(*this);
+}
+
+/////////CONTROL BLOCKS
+template<typename CounterType>
+inline void agm::ControlBlock<CounterType>::reclaim(void* block){
+	ControlBlock<CounterType>* ref = static_cast<ControlBlock<CounterType>*>(block);
+	ref->destroyObject();
+	if(ref->weakRelease() == 0){
+		ref->destroyBlock();
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType, typename AllocatorType>
+inline agm::PointerBlock<Type, DeleterType, CounterType, AllocatorType>::PointerBlock(const AllocatorType& inAllocator, Type* inObject, DeleterType inDeleter)
+	: DeleterStorage<DeleterType>(std::move(inDeleter))
+	, AllocatorStorage<AllocatorType>(inAllocator)
+	, object(inObject){
+	Telemetry::blockCreated<Type>(this);
+}
+
+template<typename Type, typename DeleterType, typename CounterType, typename AllocatorType>
+inline void agm::PointerBlock<Type, DeleterType, CounterType, AllocatorType>::destroyObject(){
+	Telemetry::objectDestroyed<Type>();
+	this->getDeleter()(object);
+	object = nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType, typename AllocatorType>
+inline void agm::PointerBlock<Type, DeleterType, CounterType, AllocatorType>::destroyBlock(){
+	Telemetry::blockDestroyed(this);
+
+	typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<PointerBlock> BlockAllocatorType;
+
+	BlockAllocatorType blockAllocator(this->getAllocator());
+	this->~PointerBlock();
+	std::allocator_traits<BlockAllocatorType>::deallocate(blockAllocator, this, 1);
+}
+
+template<typename Type, typename CounterType, typename AllocatorType>
+template<typename... ArgTypes>
+inline agm::InlineBlock<Type, CounterType, AllocatorType>::InlineBlock(const AllocatorType& inAllocator, ArgTypes&&... args)
+	: AllocatorStorage<AllocatorType>(inAllocator){
+	typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<Type> ObjectAllocatorType;
+
+	ObjectAllocatorType objectAllocator(this->getAllocator());
+	std::allocator_traits<ObjectAllocatorType>::construct(objectAllocator, &object, std::forward<ArgTypes>(args)...);
+
+	Telemetry::blockCreated<Type>(this);
+}
+
+template<typename Type, typename CounterType, typename AllocatorType>
+inline agm::InlineBlock<Type, CounterType, AllocatorType>::~InlineBlock(){
+	//Object is destroyed by destroyObject once the last strong reference is released
+}
+
+template<typename Type, typename CounterType, typename AllocatorType>
+inline Type* agm::InlineBlock<Type, CounterType, AllocatorType>::get(){
+	return &object;
+}
+
+template<typename Type, typename CounterType, typename AllocatorType>
+inline void agm::InlineBlock<Type, CounterType, AllocatorType>::destroyObject(){
+	Telemetry::objectDestroyed<Type>();
+
+	typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<Type> ObjectAllocatorType;
+
+	ObjectAllocatorType objectAllocator(this->getAllocator());
+	std::allocator_traits<ObjectAllocatorType>::destroy(objectAllocator, &object);
+}
+
+template<typename Type, typename CounterType, typename AllocatorType>
+inline void agm::InlineBlock<Type, CounterType, AllocatorType>::destroyBlock(){
+	Telemetry::blockDestroyed(this);
+
+	typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<InlineBlock> BlockAllocatorType;
+
+	BlockAllocatorType blockAllocator(this->getAllocator());
+	this->~InlineBlock();
+	std::allocator_traits<BlockAllocatorType>::deallocate(blockAllocator, this, 1);
+}
+
+template<typename BlockType, typename AllocatorType, typename... ArgTypes>
+inline BlockType* agm::AGM_ABI_NAMESPACE::createBlock(const AllocatorType& allocator, ArgTypes&&... args){
+	typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<BlockType> BlockAllocatorType;
+
+	BlockAllocatorType blockAllocator(allocator);
+	BlockType* block = std::allocator_traits<BlockAllocatorType>::allocate(blockAllocator, 1);
+	try{
+		new(block) BlockType(allocator, std::forward<ArgTypes>(args)...);
+	} catch(...){
+		std::allocator_traits<BlockAllocatorType>::deallocate(blockAllocator, block, 1);
+		throw;
+	}
+	return block;
+}
+
+template<typename Type, typename CounterType>
+inline agm::ArrayBlock<Type, CounterType>* agm::ArrayBlock<Type, CounterType>::create(std::size_t inCount, bool valueInitialise){
+	void* memory = ::operator new(elementOffset() + sizeof(Type) * inCount, std::align_val_t(allocationAlignment()));
+	ArrayBlock<Type, CounterType>* block = new(memory) ArrayBlock<Type, CounterType>(inCount);
+
+	Type* elements = reinterpret_cast<Type*>(static_cast<char*>(memory) + elementOffset());
+	std::size_t constructed = 0;
+	try{
+		for(; constructed < inCount; ++constructed){
+			if(valueInitialise){
+				new(elements + constructed) Type();
+			} else{
+				new(elements + constructed) Type;
+			}
+		}
+	} catch(...){
+		while(constructed > 0){
+			elements[--constructed].~Type();
+		}
+		block->~ArrayBlock();
+		::operator delete(memory, std::align_val_t(allocationAlignment()));
+		throw;
+	}
+
+	Telemetry::blockCreated<Type>(block);
+	return block;
+}
+
+template<typename Type, typename CounterType>
+inline Type* agm::ArrayBlock<Type, CounterType>::get(){
+	return std::launder(reinterpret_cast<Type*>(reinterpret_cast<char*>(this) + elementOffset()));
+}
+
+template<typename Type, typename CounterType>
+inline void agm::ArrayBlock<Type, CounterType>::destroyObject(){
+	Telemetry::objectDestroyed<Type>();
+
+	Type* elements = get();
+	for(std::size_t i = count; i > 0; --i){
+		elements[i - 1].~Type();
+	}
+}
+
+template<typename Type, typename CounterType>
+inline void agm::ArrayBlock<Type, CounterType>::destroyBlock(){
+	Telemetry::blockDestroyed(this);
+
+	void* memory = this;
+	this->~ArrayBlock();
+	::operator delete(memory, std::align_val_t(allocationAlignment()));
+}
+
+template<typename Type, typename CounterType>
+inline agm::ArrayBlock<Type, CounterType>::ArrayBlock(std::size_t inCount)
+	: count(inCount){
+}
+
+template<typename Type, typename CounterType>
+inline constexpr std::size_t agm::ArrayBlock<Type, CounterType>::elementOffset(){
+	return (sizeof(ArrayBlock<Type, CounterType>) + alignof(Type) - 1) / alignof(Type) * alignof(Type);
+}
+
+template<typename Type, typename CounterType>
+inline constexpr std::size_t agm::ArrayBlock<Type, CounterType>::allocationAlignment(){
+	return alignof(ArrayBlock<Type, CounterType>) > alignof(Type) ? alignof(ArrayBlock<Type, CounterType>) : alignof(Type);
+}
+
+/////////ALLOCATOR DELETER
+template<typename AllocatorType>
+inline void agm::AllocatorDeleter<AllocatorType>::operator ()(typename AllocatorTraits::value_type* ptr){
+	AllocatorTraits::destroy(this->getAllocator(), ptr);
+	AllocatorTraits::deallocate(this->getAllocator(), ptr, 1);
+}
+
+/////////TELEMETRY
+inline agm::TypeTelemetry::TypeTelemetry(const char* signature){
+	//Cut the type out of the signature of Telemetry::forType<Type>(), which is "[with Type = X]" on GCC,
+	//"[Type = X]" on Clang and "forType<X>(void)" on MSVC
+	const char* begin = std::strstr(signature, "Type = ");
+	const char* end = nullptr;
+	if(begin){
+		begin += std::strlen("Type = ");
+		int depth = 0;
+		for(end = begin; *end && !(depth == 0 && (*end == ']' || *end == ';')); ++end){
+			depth += (*end == '<' || *end == '(' || *end == '[') - (*end == '>' || *end == ')' || *end == ']');
+		}
+	} else if((begin = std::strstr(signature, "forType<"))){
+		begin += std::strlen("forType<");
+		end = std::strrchr(signature, '>');
+	}
+	if(!begin || !end || end < begin){
+		begin = signature;
+		end = signature + std::strlen(signature);
+	}
+
+	const std::size_t length = std::min(static_cast<std::size_t>(end - begin), sizeof(name) - 1);
+	std::memcpy(name, begin, length);
+	name[length] = '\0';
+}
+
+inline void agm::Telemetry::setSampleRate(std::uint32_t rate){
+	sampleRate.store(rate > 0 ? rate : 1, std::memory_order_relaxed);
+}
+
+inline std::uint32_t agm::Telemetry::getSampleRate(){
+	return sampleRate.load(std::memory_order_relaxed);
+}
+
+inline void agm::Telemetry::setCallSiteTracking(bool enabled){
+	callSiteTracking.store(enabled, std::memory_order_relaxed);
+}
+
+inline void agm::Telemetry::setLeakReportAtExit(bool enabled){
+	leakReportAtExit.store(enabled, std::memory_order_relaxed);
+}
+
+template<typename Type>
+inline agm::TypeTelemetry& agm::Telemetry::forType(){
+	//Never destroyed so objects released during static destruction can still be counted
+	static TypeTelemetry& telemetry = registerType(new TypeTelemetry(AGM_FUNCTION_NAME));
+	return telemetry;
+}
+
+inline const agm::TypeTelemetry* agm::Telemetry::getTypes(){
+	return types.load(std::memory_order_acquire);
+}
+
+inline void agm::Telemetry::report(std::FILE* out){
+	const std::uint64_t rate = getSampleRate();
+
+	std::fprintf(out, "agm telemetry, sample rate %llu\n", static_cast<unsigned long long>(rate));
+	std::fprintf(out, "%-32s %10s %10s %12s %12s %12s %12s %12s %12s\n", "type", "live", "peak", "allocations", "grabs", "releases", "weak grabs", "weak release", "unique frees");
+	for(const TypeTelemetry* type = getTypes(); type; type = type->next){
+		std::fprintf(out, "%-32s %10lld %10lld %12llu", type->name,
+			static_cast<long long>(type->live.load(std::memory_order_relaxed)),
+			static_cast<long long>(type->peak.load(std::memory_order_relaxed)),
+			static_cast<unsigned long long>(type->allocations.load(std::memory_order_relaxed)));
+		for(const std::atomic<std::uint64_t>& op : type->ops){
+			std::fprintf(out, " %12llu", static_cast<unsigned long long>(op.load(std::memory_order_relaxed) * rate));
+		}
+		std::fprintf(out, "\n");
+	}
+
+	std::vector<std::pair<const void*, CallSite>> sites;
+	{
+		std::lock_guard<std::mutex> guard(registryLock());
+		sites.assign(callSites().begin(), callSites().end());
+	}
+	if(sites.empty()){
+		return;
+	}
+
+	//The busiest call sites first
+	auto total = [](const CallSite& site){
+		std::uint64_t sum = 0;
+		for(std::uint64_t op : site.ops){
+			sum += op;
+		}
+		return sum;
+	};
+	std::sort(sites.begin(), sites.end(), [&](const auto& a, const auto& b){
+		return total(a.second) > total(b.second);
+	});
+
+	std::fprintf(out, "\n%-18s %-32s %12s %12s %12s %12s %12s\n", "call site", "type", "grabs", "releases", "weak grabs", "weak release", "unique frees");
+	for(std::size_t i = 0; i < sites.size() && i < 20; ++i){
+		std::fprintf(out, "%-18p %-32s", sites[i].first, sites[i].second.type->name);
+		for(std::uint64_t op : sites[i].second.ops){
+			std::fprintf(out, " %12llu", static_cast<unsigned long long>(op * rate));
+		}
+		std::fprintf(out, "\n");
+	}
+}
+
+inline std::size_t agm::Telemetry::reportLeaks(std::FILE* out){
+	std::lock_guard<std::mutex> guard(registryLock());
+
+	const std::unordered_map<const void*, BlockRecord>& records = blocks();
+	if(records.empty()){
+		return 0;
+	}
+
+	std::fprintf(out, "agm leak report: %zu control blocks still alive%s\n", records.size(), getSampleRate() > 1 ? " (sampled)" : "");
+	for(const auto& record : records){
+		int strong, weak;
+		record.second.counts(record.first, strong, weak);
+		std::fprintf(out, "  %-32s block %p, strong %d, weak %d\n", record.second.type->name, record.first, strong, weak);
+	}
+	return records.size();
+}
+
+template<typename Type, typename CounterType>
+inline void agm::Telemetry::blockCreated(agm::ControlBlock<CounterType>* block){
+	if constexpr(telemetryEnabled){
+		TypeTelemetry& type = forType<std::remove_cv_t<Type>>();
+		type.allocations.fetch_add(1, std::memory_order_relaxed);
+
+		const std::int64_t live = type.live.fetch_add(1, std::memory_order_relaxed) + 1;
+		std::int64_t peak = type.peak.load(std::memory_order_relaxed);
+		while(live > peak && !type.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)){
+		}
+
+		if(isTracked(block)){
+			std::lock_guard<std::mutex> guard(registryLock());
+			blocks()[block] = BlockRecord{ &type, &countsOf<CounterType> };
+		}
+	}
+}
+
+template<typename Type>
+inline void agm::Telemetry::objectDestroyed(){
+	if constexpr(telemetryEnabled){
+		forType<std::remove_cv_t<Type>>().live.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+template<typename CounterType>
+inline void agm::Telemetry::blockDestroyed(agm::ControlBlock<CounterType>* block){
+	if constexpr(telemetryEnabled){
+		if(isTracked(block)){
+			std::lock_guard<std::mutex> guard(registryLock());
+			blocks().erase(block);
+		}
+	}
+}
+
+template<typename Type>
+inline void agm::Telemetry::count(agm::TelemetryOp op){
+	if constexpr(telemetryEnabled){
+		if(sample()){
+			TypeTelemetry& type = forType<std::remove_cv_t<Type>>();
+			type.ops[static_cast<int>(op)].fetch_add(1, std::memory_order_relaxed);
+			if(callSiteTracking.load(std::memory_order_relaxed)){
+				recordCallSite(type, op);
+			}
+		}
+	}
+}
+
+inline bool agm::Telemetry::sample(){
+	const std::uint32_t rate = sampleRate.load(std::memory_order_relaxed);
+	return rate <= 1 || ++sampleTick % rate == 0;
+}
+
+inline bool agm::Telemetry::isTracked(const void* block){
+	//Decided by address so a block that was tracked when it was made is also removed when it is destroyed
+	const std::uint32_t rate = sampleRate.load(std::memory_order_relaxed);
+	return rate <= 1 || ((reinterpret_cast<std::uintptr_t>(block) * 0x9E3779B97F4A7C15ull) >> 32) % rate == 0;
+}
+
+AGM_NOINLINE inline void agm::Telemetry::recordCallSite(agm::TypeTelemetry& type, agm::TelemetryOp op){
+	const void* site = AGM_RETURN_ADDRESS();
+
+	std::lock_guard<std::mutex> guard(registryLock());
+	CallSite& callSite = callSites()[site];
+	callSite.type = &type;
+	++callSite.ops[static_cast<int>(op)];
+}
+
+template<typename CounterType>
+inline void agm::Telemetry::countsOf(const void* block, int& strong, int& weak){
+	const ControlBlock<CounterType>* controlBlock = static_cast<const ControlBlock<CounterType>*>(block);
+	strong = controlBlock->check();
+	weak = controlBlock->fullCheck() - strong;
+}
+
+inline agm::TypeTelemetry& agm::Telemetry::registerType(agm::TypeTelemetry* type){
+	static bool atExitRegistered = false;
+
+	std::lock_guard<std::mutex> guard(registryLock());
+	type->next = types.load(std::memory_order_relaxed);
+	types.store(type, std::memory_order_release);
+
+	if(!atExitRegistered){
+		std::atexit(&reportAtExit);
+		atExitRegistered = true;
+	}
+	return *type;
+}
+
+inline void agm::Telemetry::reportAtExit(){
+	if(leakReportAtExit.load(std::memory_order_relaxed)){
+		reportLeaks(stderr);
+	}
+}
+
+inline std::mutex& agm::Telemetry::registryLock(){
+	//Never destroyed so the leak report can still run during static destruction
+	static std::mutex* lock = new std::mutex();
+	return *lock;
+}
+
+inline std::unordered_map<const void*, agm::Telemetry::BlockRecord>& agm::Telemetry::blocks(){
+	static std::unordered_map<const void*, BlockRecord>* records = new std::unordered_map<const void*, BlockRecord>();
+	return *records;
+}
+
+inline std::unordered_map<const void*, agm::Telemetry::CallSite>& agm::Telemetry::callSites(){
+	static std::unordered_map<const void*, CallSite>* sites = new std::unordered_map<const void*, CallSite>();
+	return *sites;
+}
+
+/////////ACCESS CHECKS
+//Not inlined, so the return address is the place the pointer was dereferenced
+AGM_NOINLINE inline void agm::AGM_ABI_NAMESPACE::accessFailure(const char* reason, const char* function){
+	std::fprintf(stderr, "agm: dereferenced %s pointer in %s, called from %p\n", reason, function, AGM_RETURN_ADDRESS());
+	std::fflush(stderr);
+	std::abort();
+}
+
+AGM_NOINLINE inline void agm::AGM_ABI_NAMESPACE::usageFailure(const char* message, const char* function){
+	std::fprintf(stderr, "agm: %s in %s, called from %p\n", message, function, AGM_RETURN_ADDRESS());
+	std::fflush(stderr);
+	std::abort();
+}
+
 /////////POINTER BASE
-template<typename Type, typename DeleterType>
-inline Type* agm::PtrBase<Type, DeleterType>::get() const{
-	return isValid() ? object : nullptr;
+template<typename Type, typename PtrType>
+inline Type* agm::PtrBase<Type, PtrType>::get() const noexcept{
+	return self().isValid() ? object : nullptr;
+}
+
+template<typename Type, typename PtrType>
+inline bool agm::PtrBase<Type, PtrType>::isValid() const noexcept{
+	return object != nullptr;
+}
+
+template<typename Type, typename PtrType>
+inline void agm::PtrBase<Type, PtrType>::reset() noexcept{
+	self().free();
+}
+
+template<typename Type, typename PtrType>
+inline agm::PtrBase<Type, PtrType>::operator bool() const noexcept{
+	return self().isValid();
+}
+
+template<typename Type, typename PtrType>
+inline const PtrType& agm::PtrBase<Type, PtrType>::self() const noexcept{
+	return static_cast<const PtrType&>(*this);
+}
+
+template<typename Type, typename PtrType>
+inline PtrType& agm::PtrBase<Type, PtrType>::self() noexcept{
+	return static_cast<PtrType&>(*this);
+}
+
+template<typename Type, typename PtrType>
+inline Type* agm::PtrBase<Type, PtrType>::access() const noexcept{
+	if constexpr(checkedAccess){
+		if(!self().isValid()){
+			accessFailure(object ? "an expired" : "a null", AGM_FUNCTION_NAME);
+		}
+	}
+	return object;
+}
+
+/////////REFERENCE POINTER BASE
+template<typename Type, typename PtrType, typename CounterType>
+inline bool agm::RefPtrBase<Type, PtrType, CounterType>::isValid() const noexcept{
+	return (ref && ref->check() > 0) ? this->object != nullptr : false;
+}
+
+template<typename Type, typename PtrType, typename CounterType>
+template<typename OtherType, typename OtherPtrType>
+inline bool agm::RefPtrBase<Type, PtrType, CounterType>::ownerBefore(const agm::RefPtrBase<OtherType, OtherPtrType, CounterType>& ptr) const noexcept{
+	return std::less<const ControlBlock<CounterType>*>()(ref, ptr.ref);
+}
+
+template<typename Type, typename PtrType, typename CounterType>
+template<typename OtherType, typename OtherPtrType>
+inline bool agm::RefPtrBase<Type, PtrType, CounterType>::ownerEquals(const agm::RefPtrBase<OtherType, OtherPtrType, CounterType>& ptr) const noexcept{
+	return ref == ptr.ref;
+}
+
+template<typename Type, typename PtrType, typename CounterType>
+inline std::size_t agm::RefPtrBase<Type, PtrType, CounterType>::ownerHash() const noexcept{
+	return std::hash<const ControlBlock<CounterType>*>()(ref);
+}
+
+/////////SHARED POINTER
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(Type* inObject){
+	if(inObject){
+		init(inObject);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(Type* inObject, DeleterType inDeleter){
+	if(inObject){
+		initBlock(inObject, createBlock<PointerBlock<Type, DeleterType, CounterType>>(std::allocator<std::remove_cv_t<Type>>(), inObject, std::move(inDeleter)));
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename AllocatorType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(Type* inObject, DeleterType inDeleter, const AllocatorType& allocator){
+	if(inObject){
+		initBlock(inObject, createBlock<PointerBlock<Type, DeleterType, CounterType, AllocatorType>>(allocator, inObject, std::move(inDeleter)));
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(const agm::SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	if(ptr.isValid()){
+		init(ptr.object, ptr.ref);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(agm::SharedPtr<Type, DeleterType, CounterType>&& ptr) noexcept{
+	this->object = ptr.object;
+	this->ref = ptr.ref;
+	ptr.object = nullptr;
+	ptr.ref = nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(const agm::WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	initPinned(ptr.object, ptr.ref);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(const agm::SharedPtr<OtherType, DeleterType, CounterType>& ptr) noexcept{
+	if(ptr.isValid()){
+		init(ptr.object, ptr.ref);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(agm::SharedPtr<OtherType, DeleterType, CounterType>&& ptr) noexcept{
+	this->object = ptr.object;
+	this->ref = ptr.ref;
+	ptr.object = nullptr;
+	ptr.ref = nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(const agm::WeakPtr<OtherType, DeleterType, CounterType>& ptr) noexcept{
+	initPinned(ptr.object, ptr.ref);
+}
+
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(const agm::SharedPtr<OtherType, DeleterType, CounterType>& ptr, Type* obj) noexcept{
+	if(ptr.isValid() && obj){
+		init(obj, ptr.ref);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::SharedPtr(agm::SharedPtr<OtherType, DeleterType, CounterType>&& ptr, Type* obj) noexcept{
+	if(ptr.isValid() && obj){
+		this->object = obj;
+		this->ref = ptr.ref;
+		ptr.object = nullptr;
+		ptr.ref = nullptr;
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>::~SharedPtr() noexcept{
+	free();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline bool agm::SharedPtr<Type, DeleterType, CounterType>::isValid() const noexcept{
+	if constexpr(checkedAccess){
+		return RefPtrBase<Type, SharedPtr<Type, DeleterType, CounterType>, CounterType>::isValid();
+	}
+	return this->object != nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline Type* agm::SharedPtr<Type, DeleterType, CounterType>::operator ->() noexcept{
+	return this->access();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline Type* agm::SharedPtr<Type, DeleterType, CounterType>::operator ->() const noexcept{
+	return this->access();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline Type& agm::SharedPtr<Type, DeleterType, CounterType>::operator *() noexcept{
+	return *this->access();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline Type& agm::SharedPtr<Type, DeleterType, CounterType>::operator *() const noexcept{
+	return *this->access();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>& agm::SharedPtr<Type, DeleterType, CounterType>::operator =(Type* inObject){
+	if(this->object != inObject){
+		free();
+		if(inObject){
+			init(inObject);
+		}
+	}
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>& agm::SharedPtr<Type, DeleterType, CounterType>::operator =(const agm::SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	//Through a copy, as releasing the old object first could destroy ptr when the old object owns it
+	if(this != &ptr){
+		SharedPtr<Type, DeleterType, CounterType>(ptr).swap(*this);
+	}
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>& agm::SharedPtr<Type, DeleterType, CounterType>::operator =(agm::SharedPtr<Type, DeleterType, CounterType>&& ptr) noexcept{
+	if(this != &ptr){
+		SharedPtr<Type, DeleterType, CounterType>(std::move(ptr)).swap(*this);
+	}
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType>& agm::SharedPtr<Type, DeleterType, CounterType>::operator =(const agm::WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	SharedPtr<Type, DeleterType, CounterType>(ptr).swap(*this);
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type, DeleterType, CounterType>::swap(agm::SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	std::swap(this->object, ptr.object);
+	std::swap(this->ref, ptr.ref);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type, DeleterType, CounterType>::free() noexcept{
+	if(this->ref){
+		Telemetry::count<Type>(TelemetryOp::Release);
+		if constexpr(IsCollectable<Type, CounterType>::value){
+			CycleCollector<CounterType>::template possibleRoot<DeleterType>(this->object, this->ref);
+		}
+		if(this->ref->release() == 0){
+			if constexpr(IsDeferredDeleter<DeleterType>::value){
+				DeleterType::defer(&ControlBlock<CounterType>::reclaim, this->ref);
+			} else{
+				ControlBlock<CounterType>::reclaim(this->ref);
+			}
+		}
+	}
+	this->object = nullptr;
+	this->ref = nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type, DeleterType, CounterType>::init(Type* inObject, ControlBlock<CounterType>* inRef){
+	if(inRef){
+		this->object = inObject;
+		this->ref = inRef;
+		this->ref->grab();
+		Telemetry::count<Type>(TelemetryOp::Grab);
+	} else{
+		initBlock(inObject, createBlock<PointerBlock<Type, DeleterType, CounterType>>(std::allocator<std::remove_cv_t<Type>>(), inObject, DeleterType()));
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type, DeleterType, CounterType>::initBlock(Type* inObject, ControlBlock<CounterType>* inRef) noexcept{
+	this->object = inObject;
+	this->ref = inRef;
+	this->ref->grab();
+	Telemetry::count<Type>(TelemetryOp::Grab);
+
+	enable(inObject, this);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type, DeleterType, CounterType>::initPinned(Type* inObject, ControlBlock<CounterType>* inRef) noexcept{
+	//Only take a strong reference if the object is still alive, checking then grabbing could resurrect an object mid destruction
+	if(inObject && inRef && inRef->tryGrab()){
+		this->object = inObject;
+		this->ref = inRef;
+		Telemetry::count<Type>(TelemetryOp::Grab);
+	}
+}
+
+/////////SHARED ARRAY POINTER
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type[], DeleterType, CounterType>::SharedPtr(Type* inObject, std::size_t inCount){
+	if(inObject){
+		init(inObject, createBlock<PointerBlock<Type, ElementDeleterType, CounterType>>(std::allocator<std::remove_cv_t<Type>>(), inObject, ElementDeleterType()), inCount);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type[], DeleterType, CounterType>::SharedPtr(Type* inObject, std::size_t inCount, ElementDeleterType inDeleter){
+	if(inObject){
+		init(inObject, createBlock<PointerBlock<Type, ElementDeleterType, CounterType>>(std::allocator<std::remove_cv_t<Type>>(), inObject, std::move(inDeleter)), inCount);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type[], DeleterType, CounterType>::SharedPtr(const agm::SharedPtr<Type[], DeleterType, CounterType>& ptr) noexcept{
+	if(ptr.isValid()){
+		init(ptr.object, ptr.ref, ptr.count);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type[], DeleterType, CounterType>::SharedPtr(agm::SharedPtr<Type[], DeleterType, CounterType>&& ptr) noexcept{
+	this->object = ptr.object;
+	this->ref = ptr.ref;
+	count = ptr.count;
+	ptr.object = nullptr;
+	ptr.ref = nullptr;
+	ptr.count = 0;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type[], DeleterType, CounterType>::~SharedPtr() noexcept{
+	free();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline bool agm::SharedPtr<Type[], DeleterType, CounterType>::isValid() const noexcept{
+	if constexpr(checkedAccess){
+		return RefPtrBase<Type, SharedPtr<Type[], DeleterType, CounterType>, CounterType>::isValid();
+	}
+	return this->object != nullptr;
 }
 
-template<typename Type, typename DeleterType>
-inline bool agm::PtrBase<Type, DeleterType>::isValid() const{
-	return object != nullptr;
+template<typename Type, typename DeleterType, typename CounterType>
+inline Type& agm::SharedPtr<Type[], DeleterType, CounterType>::operator [](std::size_t index) const noexcept{
+	if constexpr(checkedAccess){
+		if(this->object && index >= count){
+			accessFailure("an out of range", AGM_FUNCTION_NAME);
+		}
+	}
+	return this->access()[index];
 }
 
-template<typename Type, typename DeleterType>
-inline void agm::PtrBase<Type, DeleterType>::reset(){
-	free();
+template<typename Type, typename DeleterType, typename CounterType>
+inline std::size_t agm::SharedPtr<Type[], DeleterType, CounterType>::size() const noexcept{
+	return this->isValid() ? count : 0;
 }
 
-template<typename Type, typename DeleterType>
-inline agm::PtrBase<Type, DeleterType>::operator bool() const{
-	return isValid();
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type[], DeleterType, CounterType>& agm::SharedPtr<Type[], DeleterType, CounterType>::operator =(const agm::SharedPtr<Type[], DeleterType, CounterType>& ptr) noexcept{
+	//Through a copy, as releasing the old elements first could destroy ptr when one of them owns it
+	if(this != &ptr){
+		SharedPtr<Type[], DeleterType, CounterType>(ptr).swap(*this);
+	}
+	return *this;
 }
 
-/////////REFERENCE POINTER BASE
-template<typename Type, typename DeleterType>
-inline bool agm::RefPtrBase<Type, DeleterType>::isValid() const{
-	return (ref && ref->check() > 0) ? this->object != nullptr : false;
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type[], DeleterType, CounterType>& agm::SharedPtr<Type[], DeleterType, CounterType>::operator =(agm::SharedPtr<Type[], DeleterType, CounterType>&& ptr) noexcept{
+	if(this != &ptr){
+		SharedPtr<Type[], DeleterType, CounterType>(std::move(ptr)).swap(*this);
+	}
+	return *this;
 }
 
-/////////SHARED POINTER
-template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(Type* inObject){
-	if(inObject){
-		init(inObject);
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type[], DeleterType, CounterType>::swap(agm::SharedPtr<Type[], DeleterType, CounterType>& ptr) noexcept{
+	std::swap(this->object, ptr.object);
+	std::swap(this->ref, ptr.ref);
+	std::swap(count, ptr.count);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type[], DeleterType, CounterType>::free() noexcept{
+	if(this->ref){
+		Telemetry::count<Type>(TelemetryOp::Release);
+		if(this->ref->release() == 0){
+			if constexpr(IsDeferredDeleter<DeleterType>::value){
+				DeleterType::defer(&ControlBlock<CounterType>::reclaim, this->ref);
+			} else{
+				ControlBlock<CounterType>::reclaim(this->ref);
+			}
+		}
 	}
+	this->object = nullptr;
+	this->ref = nullptr;
+	count = 0;
 }
 
-template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::SharedPtr<Type, DeleterType>& ptr){
-	if(ptr.isValid()){
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::SharedPtr<Type[], DeleterType, CounterType>::init(Type* inObject, ControlBlock<CounterType>* inRef, std::size_t inCount){
+	this->object = inObject;
+	this->ref = inRef;
+	this->ref->grab();
+	Telemetry::count<Type>(TelemetryOp::Grab);
+	count = inCount;
+}
+
+/////////WEAK POINTER
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(const agm::WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	//An expired copy keeps the owner, so it still compares and hashes the same as the original
+	if(ptr.ref){
 		init(ptr.object, ptr.ref);
 	}
 }
 
-template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::SharedPtr<Type, DeleterType>&& ptr){
-	if(ptr.isValid()){
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(agm::WeakPtr<Type, DeleterType, CounterType>&& ptr) noexcept{
+	this->object = ptr.object;
+	this->ref = ptr.ref;
+	ptr.object = nullptr;
+	ptr.ref = nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(const agm::SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	if(ptr.ref){
 		init(ptr.object, ptr.ref);
 	}
 }
 
-template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::WeakPtr<Type, DeleterType>& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(const agm::WeakPtr<OtherType, DeleterType, CounterType>& ptr) noexcept{
+	//Converting the pointer of an expired object can read its destroyed vtable, so only the owner is kept
+	if(ptr.ref){
+		init(ptr.isValid() ? ptr.object : nullptr, ptr.ref);
 	}
 }
 
-template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::WeakPtr<Type, DeleterType>&& ptr){
-	if(ptr.isValid()){
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(agm::WeakPtr<OtherType, DeleterType, CounterType>&& ptr) noexcept{
+	this->object = ptr.object;
+	this->ref = ptr.ref;
+	ptr.object = nullptr;
+	ptr.ref = nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(const agm::SharedPtr<OtherType, DeleterType, CounterType>& ptr) noexcept{
+	if(ptr.ref){
 		init(ptr.object, ptr.ref);
 	}
 }
 
-template<typename Type, typename DeleterType>
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(const agm::WeakPtr<OtherType, DeleterType, CounterType>& ptr, Type* obj) noexcept{
+	if(ptr.ref && obj){
+		init(obj, ptr.ref);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+template<typename OtherType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::WeakPtr(agm::WeakPtr<OtherType, DeleterType, CounterType>&& ptr, Type* obj) noexcept{
+	if(ptr.ref && obj){
+		this->object = obj;
+		this->ref = ptr.ref;
+		ptr.object = nullptr;
+		ptr.ref = nullptr;
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>::~WeakPtr() noexcept{
+	free();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType> agm::WeakPtr<Type, DeleterType, CounterType>::pin() noexcept{
+	return SharedPtr<Type, DeleterType, CounterType>(*this);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline Type* agm::WeakPtr<Type, DeleterType, CounterType>::operator ->() const noexcept{
+	if constexpr(checkedAccess){
+		return this->access();
+	}
+	return this->get();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>& agm::WeakPtr<Type, DeleterType, CounterType>::operator =(const agm::WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	if(this != &ptr){
+		WeakPtr<Type, DeleterType, CounterType>(ptr).swap(*this);
+	}
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>& agm::WeakPtr<Type, DeleterType, CounterType>::operator =(agm::WeakPtr<Type, DeleterType, CounterType>&& ptr) noexcept{
+	if(this != &ptr){
+		WeakPtr<Type, DeleterType, CounterType>(std::move(ptr)).swap(*this);
+	}
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType>& agm::WeakPtr<Type, DeleterType, CounterType>::operator =(const agm::SharedPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	WeakPtr<Type, DeleterType, CounterType>(ptr).swap(*this);
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::WeakPtr<Type, DeleterType, CounterType>::swap(agm::WeakPtr<Type, DeleterType, CounterType>& ptr) noexcept{
+	std::swap(this->object, ptr.object);
+	std::swap(this->ref, ptr.ref);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::WeakPtr<Type, DeleterType, CounterType>::free() noexcept{
+	if(this->ref){
+		Telemetry::count<Type>(TelemetryOp::WeakRelease);
+		if(this->ref->weakRelease() == 0){
+			this->ref->destroyBlock();
+		}
+	}
+	this->object = nullptr;
+	this->ref = nullptr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::WeakPtr<Type, DeleterType, CounterType>::init(Type* inObject, ControlBlock<CounterType>* inRef) noexcept{
+	static_assert(!IsStrongOnly<CounterType>::value, "Pointers that use a strong only counter have no weak count to make a WeakPtr with");
+
+	this->object = inObject;
+	if(inRef){
+		this->ref = inRef;
+		this->ref->weakGrab();
+		Telemetry::count<Type>(TelemetryOp::WeakGrab);
+	}
+}
+
+/////////ATOMIC SHARED POINTER
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::AtomicSharedPtr<Type, DeleterType, CounterType>::AtomicSharedPtr(agm::SharedPtr<Type, DeleterType, CounterType> ptr)
+	: packed(createSnapshot(std::move(ptr))){
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::AtomicSharedPtr<Type, DeleterType, CounterType>::~AtomicSharedPtr(){
+	retire(packed.load(std::memory_order_acquire));
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType> agm::AtomicSharedPtr<Type, DeleterType, CounterType>::load() const{
+	Snapshot* snapshot = acquire();
+	if(!snapshot){
+		return SharedPtr<Type, DeleterType, CounterType>();
+	}
+
+	SharedPtr<Type, DeleterType, CounterType> outPtr = snapshot->value;
+	release(snapshot);
+	return outPtr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::WeakPtr<Type, DeleterType, CounterType> agm::AtomicSharedPtr<Type, DeleterType, CounterType>::loadWeak() const{
+	return WeakPtr<Type, DeleterType, CounterType>(load());
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::AtomicSharedPtr<Type, DeleterType, CounterType>::store(agm::SharedPtr<Type, DeleterType, CounterType> ptr){
+	retire(packed.exchange(createSnapshot(std::move(ptr)), std::memory_order_acq_rel));
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::SharedPtr<Type, DeleterType, CounterType> agm::AtomicSharedPtr<Type, DeleterType, CounterType>::exchange(agm::SharedPtr<Type, DeleterType, CounterType> ptr){
+	std::uint64_t oldPacked = packed.exchange(createSnapshot(std::move(ptr)), std::memory_order_acq_rel);
+	Snapshot* snapshot = toSnapshot(oldPacked);
+	if(!snapshot){
+		return SharedPtr<Type, DeleterType, CounterType>();
+	}
+
+	//With no loads in flight nothing else can reach the snapshot any more, so the value can be moved out
+	SharedPtr<Type, DeleterType, CounterType> outPtr;
+	if((oldPacked >> countShift) == 0){
+		outPtr = std::move(snapshot->value);
+	} else{
+		outPtr = snapshot->value;
+	}
+	retire(oldPacked);
+	return outPtr;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline bool agm::AtomicSharedPtr<Type, DeleterType, CounterType>::compareExchange(agm::SharedPtr<Type, DeleterType, CounterType>& expected, agm::SharedPtr<Type, DeleterType, CounterType> desired){
+	std::uint64_t desiredPacked = createSnapshot(std::move(desired));
+
+	while(true){
+		Snapshot* current = acquire();
+
+		bool matches = current ? current->value.object == expected.object && current->value.ref == expected.ref : !expected.isValid();
+		if(!matches){
+			expected = current ? current->value : SharedPtr<Type, DeleterType, CounterType>();
+			release(current);
+			retire(desiredPacked);
+			return false;
+		}
+
+		std::uint64_t observed = packed.load(std::memory_order_relaxed);
+		while(toSnapshot(observed) == current){
+			if(packed.compare_exchange_weak(observed, desiredPacked, std::memory_order_acq_rel, std::memory_order_relaxed)){
+				//Our own load is part of the count moved onto the old snapshot, so drop it after retiring
+				retire(observed);
+				if(current){
+					dropHold(current);
+				}
+				return true;
+			}
+		}
+
+		//Another writer got in first, try again against the new value
+		release(current);
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline bool agm::AtomicSharedPtr<Type, DeleterType, CounterType>::isLockFree() const{
+	return packed.is_lock_free();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::AtomicSharedPtr<Type, DeleterType, CounterType>::operator agm::SharedPtr<Type, DeleterType, CounterType>() const{
+	return load();
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline agm::AtomicSharedPtr<Type, DeleterType, CounterType>& agm::AtomicSharedPtr<Type, DeleterType, CounterType>::operator =(agm::SharedPtr<Type, DeleterType, CounterType> ptr){
+	store(std::move(ptr));
+	return *this;
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline typename agm::AtomicSharedPtr<Type, DeleterType, CounterType>::Snapshot* agm::AtomicSharedPtr<Type, DeleterType, CounterType>::acquire() const{
+	std::uint64_t current = packed.load(std::memory_order_relaxed);
+	while(true){
+		if(!toSnapshot(current)){
+			return nullptr;
+		}
+		//The local count is full, wait for a reader to give one back
+		if((current >> countShift) == (~std::uint64_t(0) >> countShift)){
+			current = packed.load(std::memory_order_relaxed);
+			continue;
+		}
+		if(packed.compare_exchange_weak(current, current + countUnit, std::memory_order_acquire, std::memory_order_relaxed)){
+			return toSnapshot(current);
+		}
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::AtomicSharedPtr<Type, DeleterType, CounterType>::release(Snapshot* snapshot) const{
+	if(!snapshot){
+		return;
+	}
+
+	std::uint64_t current = packed.load(std::memory_order_relaxed);
+	while(toSnapshot(current) == snapshot){
+		if(packed.compare_exchange_weak(current, current - countUnit, std::memory_order_release, std::memory_order_relaxed)){
+			return;
+		}
+	}
+	//The snapshot was replaced while we were reading it and our count was moved onto its holds
+	dropHold(snapshot);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline std::uint64_t agm::AtomicSharedPtr<Type, DeleterType, CounterType>::createSnapshot(agm::SharedPtr<Type, DeleterType, CounterType>&& ptr){
+	if(!ptr.isValid()){
+		return 0;
+	}
+
+	Snapshot* snapshot = new Snapshot();
+	snapshot->value = std::move(ptr);
+	return reinterpret_cast<std::uintptr_t>(snapshot);
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::AtomicSharedPtr<Type, DeleterType, CounterType>::retire(std::uint64_t oldPacked){
+	Snapshot* snapshot = toSnapshot(oldPacked);
+	if(!snapshot){
+		return;
+	}
+
+	//Readers that already dropped their hold have pushed holds below zero, so it reaches zero once all of them are done
+	std::int64_t transferred = static_cast<std::int64_t>(oldPacked >> countShift);
+	if(snapshot->holds.fetch_add(transferred, std::memory_order_acq_rel) + transferred == 0){
+		delete snapshot;
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline void agm::AtomicSharedPtr<Type, DeleterType, CounterType>::dropHold(Snapshot* snapshot){
+	if(snapshot->holds.fetch_sub(1, std::memory_order_acq_rel) == 1){
+		delete snapshot;
+	}
+}
+
+template<typename Type, typename DeleterType, typename CounterType>
+inline typename agm::AtomicSharedPtr<Type, DeleterType, CounterType>::Snapshot* agm::AtomicSharedPtr<Type, DeleterType, CounterType>::toSnapshot(std::uint64_t value){
+	return reinterpret_cast<Snapshot*>(static_cast<std::uintptr_t>(value & pointerMask));
+}
+
+/////////SHARED FROM THIS
+template<typename Type, typename CounterType>
+inline agm::WeakPtr<Type, agm::DefaultDeleter, CounterType> agm::SharedFromThis<Type, CounterType>::getWeakThis() const noexcept{
+	return weakThis;
+}
+
+template<typename Type, typename CounterType>
+inline agm::SharedPtr<Type, agm::DefaultDeleter, CounterType> agm::SharedFromThis<Type, CounterType>::getSharedThis() const noexcept{
+	return SharedPtr<Type, DefaultDeleter, CounterType>(getWeakThis());
+}
+
+template<typename Type, typename CounterType>
+template<typename OtherType>
+inline agm::WeakPtr<OtherType, agm::DefaultDeleter, CounterType> agm::SharedFromThis<Type, CounterType>::getWeakThis() const noexcept{
+	return staticCast<OtherType>(getSharedThis());
+}
+
+template<typename Type, typename CounterType>
 template<typename OtherType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::SharedPtr<OtherType, DeleterType>& ptr){
+inline agm::SharedPtr<OtherType, agm::DefaultDeleter, CounterType> agm::SharedFromThis<Type, CounterType>::getSharedThis() const noexcept{
+	return staticCast<OtherType>(getSharedThis());
+}
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	template<typename OtherType, typename DeleterType, typename OtherCounterType, std::enable_if_t<hasSharedFromThisType<OtherType>::value, int>>
+	inline void enable(OtherType* ptr, SharedPtr<OtherType, DeleterType, OtherCounterType>* shptr){
+		if(ptr){
+			ptr->doEnable(ptr, shptr);
+		}
+	}
+
+	inline void enable(...){
+		//Not of type SharedFromThis - Do nothing
+	}
+}
+}
+
+template<typename Type, typename CounterType>
+template<typename PtrType, typename DeleterType>
+inline void agm::SharedFromThis<Type, CounterType>::doEnable(Type* ptr, agm::SharedPtr<PtrType, DeleterType, CounterType>* shptr){
+	if(ptr && shptr){
+		ptr->weakThis.init(ptr, shptr->ref);
+	}
+}
+
+/////////INTRUSIVE BLOCK
+template<typename Type, typename CounterType>
+template<typename... ArgTypes>
+inline agm::IntrusiveBlock<Type, CounterType>* agm::IntrusiveBlock<Type, CounterType>::create(ArgTypes&&... args){
+	typedef RefCounted<typename Type::RefCountedType, CounterType> RootType;
+	static_assert(sizeof(IntrusiveBlock<Type, CounterType>) == sizeof(ControlBlock<CounterType>), "RefCounted::getBlock expects every IntrusiveBlock to be the size of a ControlBlock");
+
+	void* memory = ::operator new(objectOffset() + sizeof(Type), std::align_val_t(allocationAlignment()));
+	char* objectMemory = static_cast<char*>(memory) + objectOffset();
+	IntrusiveBlock<Type, CounterType>* block = new(objectMemory - sizeof(IntrusiveBlock<Type, CounterType>)) IntrusiveBlock<Type, CounterType>();
+	try{
+		new(objectMemory) Type(std::forward<ArgTypes>(args)...);
+	} catch(...){
+		block->~IntrusiveBlock();
+		::operator delete(memory, std::align_val_t(allocationAlignment()));
+		throw;
+	}
+
+	//Known at compile time, so this folds away unless RefCounted comes after another non empty base
+	const RootType* root = block->get();
+	if(static_cast<const void*>(root) != static_cast<const void*>(objectMemory)){
+		usageFailure("RefCounted is not at the start of the object", AGM_FUNCTION_NAME);
+	}
+
+	if constexpr(checkedAccess){
+		std::lock_guard<std::mutex> guard(RootType::registryLock());
+		RootType::liveObjects().insert(root);
+	}
+
+	Telemetry::blockCreated<Type>(block);
+	return block;
+}
+
+template<typename Type, typename CounterType>
+inline Type* agm::IntrusiveBlock<Type, CounterType>::get(){
+	return std::launder(reinterpret_cast<Type*>(reinterpret_cast<char*>(this) + sizeof(IntrusiveBlock<Type, CounterType>)));
+}
+
+template<typename Type, typename CounterType>
+inline void agm::IntrusiveBlock<Type, CounterType>::destroyObject(){
+	typedef RefCounted<typename Type::RefCountedType, CounterType> RootType;
+
+	if constexpr(checkedAccess){
+		std::lock_guard<std::mutex> guard(RootType::registryLock());
+		RootType::liveObjects().erase(get());
+	}
+
+	Telemetry::objectDestroyed<Type>();
+	get()->~Type();
+}
+
+template<typename Type, typename CounterType>
+inline void agm::IntrusiveBlock<Type, CounterType>::destroyBlock(){
+	Telemetry::blockDestroyed(this);
+
+	void* memory = reinterpret_cast<char*>(this) + sizeof(IntrusiveBlock<Type, CounterType>) - objectOffset();
+	this->~IntrusiveBlock();
+	::operator delete(memory, std::align_val_t(allocationAlignment()));
+}
+
+template<typename Type, typename CounterType>
+inline constexpr std::size_t agm::IntrusiveBlock<Type, CounterType>::objectOffset(){
+	return (sizeof(IntrusiveBlock<Type, CounterType>) + alignof(Type) - 1) / alignof(Type) * alignof(Type);
+}
+
+template<typename Type, typename CounterType>
+inline constexpr std::size_t agm::IntrusiveBlock<Type, CounterType>::allocationAlignment(){
+	return alignof(IntrusiveBlock<Type, CounterType>) > alignof(Type) ? alignof(IntrusiveBlock<Type, CounterType>) : alignof(Type);
+}
+
+/////////REF COUNTED
+template<typename Type, typename CounterType>
+inline agm::IntrusivePtr<Type, CounterType> agm::RefCounted<Type, CounterType>::getIntrusiveThis() const noexcept{
+	return IntrusivePtr<Type, CounterType>(const_cast<Type*>(static_cast<const Type*>(this)));
+}
+
+template<typename Type, typename CounterType>
+inline agm::SharedPtr<Type, agm::DefaultDeleter, CounterType> agm::RefCounted<Type, CounterType>::getSharedThis() const noexcept{
+	return getIntrusiveThis().getShared();
+}
+
+template<typename Type, typename CounterType>
+inline agm::WeakPtr<Type, agm::DefaultDeleter, CounterType> agm::RefCounted<Type, CounterType>::getWeakThis() const noexcept{
+	return getIntrusiveThis().getWeak();
+}
+
+template<typename Type, typename CounterType>
+inline agm::ControlBlock<CounterType>* agm::RefCounted<Type, CounterType>::getBlock() const noexcept{
+	char* object = reinterpret_cast<char*>(const_cast<RefCounted<Type, CounterType>*>(this));
+	return std::launder(reinterpret_cast<ControlBlock<CounterType>*>(object - sizeof(ControlBlock<CounterType>)));
+}
+
+template<typename Type, typename CounterType>
+inline std::mutex& agm::RefCounted<Type, CounterType>::registryLock(){
+	static std::mutex lock;
+	return lock;
+}
+
+template<typename Type, typename CounterType>
+inline std::unordered_set<const agm::RefCounted<Type, CounterType>*>& agm::RefCounted<Type, CounterType>::liveObjects(){
+	static std::unordered_set<const RefCounted<Type, CounterType>*> objects;
+	return objects;
+}
+
+/////////INTRUSIVE POINTER
+template<typename Type, typename CounterType>
+inline agm::IntrusivePtr<Type, CounterType>::IntrusivePtr(Type* inObject) noexcept{
+	if(inObject){
+		if constexpr(checkedAccess){
+			typedef RefCounted<typename Type::RefCountedType, CounterType> RootType;
+
+			std::lock_guard<std::mutex> guard(RootType::registryLock());
+			if(RootType::liveObjects().count(inObject) == 0){
+				usageFailure("IntrusivePtr made from an object that wasn't created by makeIntrusive", AGM_FUNCTION_NAME);
+			}
+		}
+		init(inObject);
+	}
+}
+
+template<typename Type, typename CounterType>
+inline agm::IntrusivePtr<Type, CounterType>::IntrusivePtr(const agm::IntrusivePtr<Type, CounterType>& ptr) noexcept{
 	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
+		init(ptr.object);
 	}
 }
 
-template<typename Type, typename DeleterType>
+template<typename Type, typename CounterType>
+inline agm::IntrusivePtr<Type, CounterType>::IntrusivePtr(agm::IntrusivePtr<Type, CounterType>&& ptr) noexcept{
+	this->object = ptr.object;
+	ptr.object = nullptr;
+}
+
+template<typename Type, typename CounterType>
 template<typename OtherType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::SharedPtr<OtherType, DeleterType>&& ptr){
+inline agm::IntrusivePtr<Type, CounterType>::IntrusivePtr(const agm::IntrusivePtr<OtherType, CounterType>& ptr) noexcept{
 	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
+		init(ptr.object);
+	}
+}
+
+template<typename Type, typename CounterType>
+template<typename OtherType>
+inline agm::IntrusivePtr<Type, CounterType>::IntrusivePtr(agm::IntrusivePtr<OtherType, CounterType>&& ptr) noexcept{
+	this->object = ptr.object;
+	ptr.object = nullptr;
+}
+
+template<typename Type, typename CounterType>
+inline agm::IntrusivePtr<Type, CounterType>::~IntrusivePtr() noexcept{
+	free();
+}
+
+template<typename Type, typename CounterType>
+inline agm::SharedPtr<Type, agm::DefaultDeleter, CounterType> agm::IntrusivePtr<Type, CounterType>::getShared() const noexcept{
+	SharedPtr<Type, DefaultDeleter, CounterType> outPtr;
+	if(this->isValid()){
+		outPtr.init(this->object, getBlock(this->object));
 	}
+	return outPtr;
+}
+
+template<typename Type, typename CounterType>
+inline agm::WeakPtr<Type, agm::DefaultDeleter, CounterType> agm::IntrusivePtr<Type, CounterType>::getWeak() const noexcept{
+	WeakPtr<Type, DefaultDeleter, CounterType> outPtr;
+	if(this->isValid()){
+		outPtr.init(this->object, getBlock(this->object));
+	}
+	return outPtr;
+}
+
+template<typename Type, typename CounterType>
+inline Type* agm::IntrusivePtr<Type, CounterType>::operator ->() const noexcept{
+	return this->access();
 }
 
-template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::WeakPtr<OtherType, DeleterType>& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
+template<typename Type, typename CounterType>
+inline Type& agm::IntrusivePtr<Type, CounterType>::operator *() const noexcept{
+	return *this->access();
 }
 
-template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::WeakPtr<OtherType, DeleterType>&& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
+template<typename Type, typename CounterType>
+inline agm::IntrusivePtr<Type, CounterType>& agm::IntrusivePtr<Type, CounterType>::operator =(const agm::IntrusivePtr<Type, CounterType>& ptr) noexcept{
+	//Through a copy, as releasing the old object first could destroy ptr when the old object owns it
+	if(this != &ptr){
+		IntrusivePtr<Type, CounterType>(ptr).swap(*this);
 	}
+	return *this;
 }
 
-
-template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::SharedPtr<Type, DeleterType>::SharedPtr(const agm::SharedPtr<OtherType, DeleterType>& ptr, Type* obj){
-	if(ptr.isValid() && obj){
-		init(obj, ptr.ref);
+template<typename Type, typename CounterType>
+inline agm::IntrusivePtr<Type, CounterType>& agm::IntrusivePtr<Type, CounterType>::operator =(agm::IntrusivePtr<Type, CounterType>&& ptr) noexcept{
+	if(this != &ptr){
+		IntrusivePtr<Type, CounterType>(std::move(ptr)).swap(*this);
 	}
+	return *this;
 }
 
-template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>::~SharedPtr(){
-	free();
+template<typename Type, typename CounterType>
+inline void agm::IntrusivePtr<Type, CounterType>::swap(agm::IntrusivePtr<Type, CounterType>& ptr) noexcept{
+	std::swap(this->object, ptr.object);
 }
 
-template<typename Type, typename DeleterType>
-inline Type* agm::SharedPtr<Type, DeleterType>::operator ->(){
-	return this->get();
+template<typename Type, typename CounterType>
+inline void agm::IntrusivePtr<Type, CounterType>::free() noexcept{
+	if(this->object){
+		ControlBlock<CounterType>* block = getBlock(this->object);
+		Telemetry::count<Type>(TelemetryOp::Release);
+		if(block->release() == 0){
+			block->destroyObject();
+			if(block->weakRelease() == 0){
+				block->destroyBlock();
+			}
+		}
+	}
+	this->object = nullptr;
 }
 
-template<typename Type, typename DeleterType>
-inline Type* agm::SharedPtr<Type, DeleterType>::operator ->() const{
-	return this->get();
+template<typename Type, typename CounterType>
+inline void agm::IntrusivePtr<Type, CounterType>::init(Type* inObject) noexcept{
+	this->object = inObject;
+	getBlock(inObject)->grab();
+	Telemetry::count<Type>(TelemetryOp::Grab);
 }
 
-template<typename Type, typename DeleterType>
-inline Type& agm::SharedPtr<Type, DeleterType>::operator *(){
-	return *this->get();
+template<typename Type, typename CounterType>
+inline agm::ControlBlock<CounterType>* agm::IntrusivePtr<Type, CounterType>::getBlock(Type* inObject) noexcept{
+	static_assert(std::is_base_of<RefCounted<typename Type::RefCountedType, CounterType>, Type>::value, "IntrusivePtr can only point to types that inherit from RefCounted<Base, CounterType>");
+
+	const RefCounted<typename Type::RefCountedType, CounterType>* root = inObject;
+	return root->getBlock();
 }
 
+/////////UNIQUE POINTER
 template<typename Type, typename DeleterType>
-inline Type& agm::SharedPtr<Type, DeleterType>::operator *() const{
-	return *this->get();
+inline agm::UniquePtr<Type, DeleterType>::UniquePtr(Type* inObject) noexcept{
+	this->object = inObject;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>& agm::SharedPtr<Type, DeleterType>::operator =(Type* inObject){
-	if(this->object != inObject){
-		free();
-		if(inObject){
-			init(inObject);
-		}
-	}
-	return *this;
+inline agm::UniquePtr<Type, DeleterType>::UniquePtr(Type* inObject, DeleterType inDeleter) noexcept
+	: DeleterStorage<DeleterType>(std::move(inDeleter)){
+	this->object = inObject;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>& agm::SharedPtr<Type, DeleterType>::operator =(const agm::SharedPtr<Type, DeleterType>& ptr){
-	if(this != &ptr){
-		free();
-		if(ptr.isValid()){
-			init(ptr.object, ptr.ref);
-		}
-	}
-	return *this;
+inline agm::UniquePtr<Type, DeleterType>::UniquePtr(agm::UniquePtr<Type, DeleterType>&& ptr) noexcept
+	: DeleterStorage<DeleterType>(std::move(ptr.getDeleter())){
+	this->object = ptr.object;
+	ptr.object = nullptr;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>& agm::SharedPtr<Type, DeleterType>::operator =(const agm::SharedPtr<Type, DeleterType>&& ptr){
-	if(this != &ptr){
-		free();
-		if(ptr.isValid()){
-			init(ptr.object, ptr.ref);
-		}
-	}
-	return *this;
+template<typename OtherType>
+inline agm::UniquePtr<Type, DeleterType>::UniquePtr(agm::UniquePtr<OtherType, DeleterType>&& ptr) noexcept
+	: DeleterStorage<DeleterType>(std::move(ptr.getDeleter())){
+	this->object = ptr.object;
+	ptr.object = nullptr;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>& agm::SharedPtr<Type, DeleterType>::operator =(const agm::WeakPtr<Type, DeleterType>& ptr){
-	free();
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
-	return *this;
+template<typename OtherType>
+inline agm::UniquePtr<Type, DeleterType>::UniquePtr(agm::UniquePtr<OtherType, DeleterType>&& ptr, Type* obj) noexcept
+	: DeleterStorage<DeleterType>(std::move(ptr.getDeleter())){
+	this->object = obj;
+	ptr.object = nullptr;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType>& agm::SharedPtr<Type, DeleterType>::operator =(const agm::WeakPtr<Type, DeleterType>&& ptr){
+inline agm::UniquePtr<Type, DeleterType>::~UniquePtr() noexcept{
 	free();
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
-	return *this;
 }
 
 template<typename Type, typename DeleterType>
-inline void agm::SharedPtr<Type, DeleterType>::free(){
-	if(this->ref && this->ref->release() == 0){
-		this->deleter(this->get());
-		if(this->ref->fullCheck() == 0){
-			delete this->ref;
-		}
-	}
+inline agm::UniquePtr<Type, DeleterType> agm::UniquePtr<Type, DeleterType>::move() noexcept{
+	UniquePtr<Type, DeleterType> out(this->object, std::move(this->getDeleter()));
 	this->object = nullptr;
-	this->ref = nullptr;
+	return out;
 }
 
 template<typename Type, typename DeleterType>
-inline void agm::SharedPtr<Type, DeleterType>::init(Type* inObject, Counter* inRef){
-	this->object = inObject;
-	if(inRef){
-		this->ref = inRef;
-		this->ref->grab();
-	} else{
-		this->ref = new Counter();
-		this->ref->grab();
-
-		enable(inObject, this);
-	}
+inline Type* agm::UniquePtr<Type, DeleterType>::operator ->() noexcept{
+	return this->access();
 }
 
-/////////WEAK POINTER
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::WeakPtr<Type, DeleterType>& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
+inline Type* agm::UniquePtr<Type, DeleterType>::operator ->() const noexcept{
+	return this->access();
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::WeakPtr<Type, DeleterType>&& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
+inline Type& agm::UniquePtr<Type, DeleterType>::operator *() noexcept{
+	return *this->access();
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::SharedPtr<Type, DeleterType>& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
+inline Type& agm::UniquePtr<Type, DeleterType>::operator *() const noexcept{
+	return *this->access();
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::SharedPtr<Type, DeleterType>&& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
+inline agm::UniquePtr<Type, DeleterType>& agm::UniquePtr<Type, DeleterType>::operator =(agm::UniquePtr<Type, DeleterType>&& ptr) noexcept{
+	if(this != &ptr){
+		//The old object is only destroyed once ptr has been taken over, as it may be the one that owns ptr
+		UniquePtr<Type, DeleterType> old = move();
+		this->object = ptr.object;
+		this->getDeleter() = std::move(ptr.getDeleter());
+		ptr.object = nullptr;
 	}
+	return *this;
 }
 
 template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::WeakPtr<OtherType, DeleterType>& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
+inline void agm::UniquePtr<Type, DeleterType>::free() noexcept{
+	if(this->isValid()){
+		Telemetry::count<Type>(TelemetryOp::UniqueFree);
+		if constexpr(IsDeferredDeleter<DeleterType>::value){
+			DeleterType::defer(&reclaim, this->get());
+		} else{
+			this->getDeleter()(this->get());
+		}
 	}
+	this->object = nullptr;
 }
 
 template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::WeakPtr<OtherType, DeleterType>&& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
+inline void agm::UniquePtr<Type, DeleterType>::reclaim(void* inObject) noexcept{
+	DeleterType()(static_cast<Type*>(inObject));
 }
 
+/////////UNIQUE ARRAY POINTER
 template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::SharedPtr<OtherType, DeleterType>& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
+inline agm::UniquePtr<Type[], DeleterType>::UniquePtr(Type* inObject, std::size_t inCount) noexcept
+	: count(inCount){
+	this->object = inObject;
 }
 
 template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::WeakPtr<Type, DeleterType>::WeakPtr(const agm::SharedPtr<OtherType, DeleterType>&& ptr){
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
+inline agm::UniquePtr<Type[], DeleterType>::UniquePtr(Type* inObject, std::size_t inCount, ElementDeleterType inDeleter) noexcept
+	: DeleterStorage<ElementDeleterType>(std::move(inDeleter))
+	, count(inCount){
+	this->object = inObject;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>::~WeakPtr(){
-	free();
+inline agm::UniquePtr<Type[], DeleterType>::UniquePtr(agm::UniquePtr<Type[], DeleterType>&& ptr) noexcept
+	: DeleterStorage<ElementDeleterType>(std::move(ptr.getDeleter()))
+	, count(ptr.count){
+	this->object = ptr.object;
+	ptr.object = nullptr;
+	ptr.count = 0;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::SharedPtr<Type, DeleterType> agm::WeakPtr<Type, DeleterType>::pin(){
-	return SharedPtr<Type, DeleterType>(*this);
+inline agm::UniquePtr<Type[], DeleterType>::~UniquePtr() noexcept{
+	free();
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>& agm::WeakPtr<Type, DeleterType>::operator =(const agm::WeakPtr<Type, DeleterType>& ptr){
-	if(this != &ptr){
-		free();
-		if(ptr.isValid()){
-			init(ptr.object, ptr.ref);
-		}
-	}
-	return *this;
+inline agm::UniquePtr<Type[], DeleterType> agm::UniquePtr<Type[], DeleterType>::move() noexcept{
+	UniquePtr<Type[], DeleterType> out(this->object, count, std::move(this->getDeleter()));
+	this->object = nullptr;
+	count = 0;
+	return out;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>& agm::WeakPtr<Type, DeleterType>::operator =(const agm::WeakPtr<Type, DeleterType>&& ptr){
-	if(this != &ptr){
-		free();
-		if(ptr.isValid()){
-			init(ptr.object, ptr.ref);
+inline Type& agm::UniquePtr<Type[], DeleterType>::operator [](std::size_t index) const noexcept{
+	if constexpr(checkedAccess){
+		if(this->object && index >= count){
+			accessFailure("an out of range", AGM_FUNCTION_NAME);
 		}
 	}
-	return *this;
+	return this->access()[index];
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>& agm::WeakPtr<Type, DeleterType>::operator =(const agm::SharedPtr<Type, DeleterType>& ptr){
-	free();
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
-	}
-	return *this;
+inline std::size_t agm::UniquePtr<Type[], DeleterType>::size() const noexcept{
+	return this->isValid() ? count : 0;
 }
 
 template<typename Type, typename DeleterType>
-inline agm::WeakPtr<Type, DeleterType>& agm::WeakPtr<Type, DeleterType>::operator =(const agm::SharedPtr<Type, DeleterType>&& ptr){
-	free();
-	if(ptr.isValid()){
-		init(ptr.object, ptr.ref);
+inline agm::UniquePtr<Type[], DeleterType>& agm::UniquePtr<Type[], DeleterType>::operator =(agm::UniquePtr<Type[], DeleterType>&& ptr) noexcept{
+	if(this != &ptr){
+		//The old elements are only destroyed once ptr has been taken over, as one of them may own ptr
+		UniquePtr<Type[], DeleterType> old = move();
+		this->object = ptr.object;
+		this->getDeleter() = std::move(ptr.getDeleter());
+		count = ptr.count;
+		ptr.object = nullptr;
+		ptr.count = 0;
 	}
 	return *this;
 }
 
 template<typename Type, typename DeleterType>
-inline void agm::WeakPtr<Type, DeleterType>::free(){
-	if(this->ref && this->ref->weakRelease() == 0 && this->ref->fullCheck() == 0){
-		delete this->ref;
+inline void agm::UniquePtr<Type[], DeleterType>::free() noexcept{
+	if(this->isValid()){
+		Telemetry::count<Type>(TelemetryOp::UniqueFree);
+		if constexpr(IsDeferredDeleter<DeleterType>::value){
+			DeleterType::defer(&reclaim, this->get());
+		} else{
+			this->getDeleter()(this->get());
+		}
 	}
 	this->object = nullptr;
-	this->ref = nullptr;
+	count = 0;
 }
 
 template<typename Type, typename DeleterType>
-inline void agm::WeakPtr<Type, DeleterType>::init(Type* inObject, Counter* inRef){
-	this->object = inObject;
-	if(inRef){
-		this->ref = inRef;
-		this->ref->weakGrab();
-	}
+inline void agm::UniquePtr<Type[], DeleterType>::reclaim(void* inObject) noexcept{
+	ElementDeleterType()(static_cast<Type*>(inObject));
 }
 
-/////////SHARED FROM THIS
-template<typename Type>
-inline agm::WeakPtr<Type> agm::SharedFromThis<Type>::getWeakThis() const{
-	return weakThis;
+/////////OWNER COMPARISON
+template<typename LeftType, typename RightType>
+inline bool agm::OwnerLess::operator ()(const LeftType& lptr, const RightType& rptr) const noexcept{
+	return lptr.ownerBefore(rptr);
+}
+
+template<typename LeftType, typename RightType>
+inline bool agm::OwnerEqual::operator ()(const LeftType& lptr, const RightType& rptr) const noexcept{
+	return lptr.ownerEquals(rptr);
 }
 
+template<typename PtrType>
+inline std::size_t agm::OwnerHash::operator ()(const PtrType& ptr) const noexcept{
+	return ptr.ownerHash();
+}
+
+/////////HELPER FUNCTIONS
 template<typename Type>
-inline agm::SharedPtr<Type> agm::SharedFromThis<Type>::getSharedThis() const{
-	return SharedPtr<Type>(getWeakThis());
+agm::UniquePtr<Type> agm::AGM_ABI_NAMESPACE::makeUnique(Type* object){
+	return UniquePtr<Type>(object);
+}
+
+template<typename Type, typename CounterType>
+agm::SharedPtr<Type, agm::DefaultDeleter, CounterType> agm::AGM_ABI_NAMESPACE::adoptShared(Type* object){
+	return SharedPtr<Type, DefaultDeleter, CounterType>(object);
+}
+
+template<typename Type, typename CounterType, typename... ArgTypes>
+agm::SharedPtr<Type, agm::DefaultDeleter, CounterType> agm::AGM_ABI_NAMESPACE::makeShared(ArgTypes&&... args){
+	return allocateShared<Type, CounterType>(std::allocator<std::remove_cv_t<Type>>(), std::forward<ArgTypes>(args)...);
 }
 
 template<typename Type>
-template<typename OtherType>
-inline agm::WeakPtr<OtherType> agm::SharedFromThis<Type>::getWeakThis() const{
-	return staticCast<OtherType, Type>(weakThis);
+agm::UniquePtr<Type[]> agm::AGM_ABI_NAMESPACE::makeUniqueArray(std::size_t count){
+	return UniquePtr<Type[]>(new Type[count](), count);
 }
 
 template<typename Type>
-template<typename OtherType>
-inline agm::SharedPtr<OtherType> agm::SharedFromThis<Type>::getSharedThis() const{
-	return SharedPtr<OtherType>(getWeakThis<OtherType>());
+agm::UniquePtr<Type[]> agm::AGM_ABI_NAMESPACE::makeUniqueArrayUninitialised(std::size_t count){
+	static_assert(std::is_trivially_default_constructible<Type>::value, "Only trivially constructible types can be left uninitialised");
+	return UniquePtr<Type[]>(new Type[count], count);
 }
 
-namespace agm{
-	template<typename Type, std::enable_if_t<hasSharedFromThisType<Type>::value, int>>
-	inline void enable(Type* ptr, SharedPtr<Type>* shptr){
-		if(ptr){
-			ptr->doEnable(ptr, shptr);
-		}
-	}
+template<typename Type, typename CounterType>
+agm::SharedPtr<Type[], agm::DefaultDeleter, CounterType> agm::AGM_ABI_NAMESPACE::makeSharedArray(std::size_t count){
+	ArrayBlock<Type, CounterType>* block = ArrayBlock<Type, CounterType>::create(count, true);
+	SharedPtr<Type[], DefaultDeleter, CounterType> outPtr;
+	outPtr.init(block->get(), block, count);
+	return outPtr;
+}
 
-	inline void enable(...){
-		//Not of type SharedFromThis - Do nothing
-	}
+template<typename Type, typename CounterType>
+agm::SharedPtr<Type[], agm::DefaultDeleter, CounterType> agm::AGM_ABI_NAMESPACE::makeSharedArrayUninitialised(std::size_t count){
+	static_assert(std::is_trivially_default_constructible<Type>::value, "Only trivially constructible types can be left uninitialised");
+
+	ArrayBlock<Type, CounterType>* block = ArrayBlock<Type, CounterType>::create(count, false);
+	SharedPtr<Type[], DefaultDeleter, CounterType> outPtr;
+	outPtr.init(block->get(), block, count);
+	return outPtr;
 }
 
-template<typename Type>
-template<typename PtrType>
-inline void agm::SharedFromThis<Type>::doEnable(Type* ptr, agm::SharedPtr<PtrType>* shptr){
-	if(ptr && shptr){
-		ptr->weakThis.init(shptr->get(), shptr->ref);
+template<typename Type, typename CounterType, typename AllocatorType, typename... ArgTypes>
+agm::SharedPtr<Type, agm::DefaultDeleter, CounterType> agm::AGM_ABI_NAMESPACE::allocateShared(const AllocatorType& allocator, ArgTypes&&... args){
+	InlineBlock<Type, CounterType, AllocatorType>* block = createBlock<InlineBlock<Type, CounterType, AllocatorType>>(allocator, std::forward<ArgTypes>(args)...);
+	SharedPtr<Type, DefaultDeleter, CounterType> outPtr;
+	outPtr.initBlock(block->get(), block);
+	return outPtr;
+}
+
+template<typename Type, typename AllocatorType, typename... ArgTypes>
+agm::UniquePtr<Type, agm::AllocatorDeleter<typename std::allocator_traits<AllocatorType>::template rebind_alloc<Type>>> agm::AGM_ABI_NAMESPACE::allocateUnique(const AllocatorType& allocator, ArgTypes&&... args){
+	typedef typename std::allocator_traits<AllocatorType>::template rebind_alloc<Type> ObjectAllocatorType;
+	typedef std::allocator_traits<ObjectAllocatorType> ObjectAllocatorTraits;
+
+	ObjectAllocatorType objectAllocator(allocator);
+	Type* object = ObjectAllocatorTraits::allocate(objectAllocator, 1);
+	try{
+		ObjectAllocatorTraits::construct(objectAllocator, object, std::forward<ArgTypes>(args)...);
+	} catch(...){
+		ObjectAllocatorTraits::deallocate(objectAllocator, object, 1);
+		throw;
 	}
+	return UniquePtr<Type, AllocatorDeleter<ObjectAllocatorType>>(object, AllocatorDeleter<ObjectAllocatorType>(objectAllocator));
 }
 
-/////////UNIQUE POINTER
-template<typename Type, typename DeleterType>
-inline agm::UniquePtr<Type, DeleterType>::UniquePtr(Type* inObject){
-	this->object = inObject;
+inline void agm::AGM_ABI_NAMESPACE::mergeBiasedCounts() noexcept{
+	BiasedCounter::mergePending();
 }
 
-template<typename Type, typename DeleterType>
-inline agm::UniquePtr<Type, DeleterType>::UniquePtr(agm::UniquePtr<Type, DeleterType>&& ptr){
-	this->object = ptr.object;
-	ptr.object = nullptr;
+template<typename Type, typename DeleterType, typename CounterType>
+void agm::AGM_ABI_NAMESPACE::swap(agm::SharedPtr<Type, DeleterType, CounterType>& lptr, agm::SharedPtr<Type, DeleterType, CounterType>& rptr) noexcept{
+	lptr.swap(rptr);
 }
 
-template<typename Type, typename DeleterType>
-template<typename OtherType>
-inline agm::UniquePtr<Type, DeleterType>::UniquePtr(agm::UniquePtr<OtherType, DeleterType>&& ptr){
-	this->object = ptr.object;
-	ptr.object = nullptr;
+template<typename Type, typename DeleterType, typename CounterType>
+void agm::AGM_ABI_NAMESPACE::swap(agm::WeakPtr<Type, DeleterType, CounterType>& lptr, agm::WeakPtr<Type, DeleterType, CounterType>& rptr) noexcept{
+	lptr.swap(rptr);
 }
 
-template<typename Type, typename DeleterType>
-inline agm::UniquePtr<Type, DeleterType>::~UniquePtr(){
-	free();
+template<typename Type, typename CounterType>
+void agm::AGM_ABI_NAMESPACE::swap(agm::IntrusivePtr<Type, CounterType>& lptr, agm::IntrusivePtr<Type, CounterType>& rptr) noexcept{
+	lptr.swap(rptr);
 }
 
-template<typename Type, typename DeleterType>
-inline agm::UniquePtr<Type, DeleterType> agm::UniquePtr<Type, DeleterType>::move(){
-	UniquePtr<Type, DeleterType> out(this->object);
-	this->object = nullptr;
-	return out;
+template<typename Type, typename... ArgTypes>
+agm::IntrusivePtr<Type, typename Type::RefCountedCounterType> agm::AGM_ABI_NAMESPACE::makeIntrusive(ArgTypes&&... args){
+	typedef typename Type::RefCountedCounterType CounterType;
+	static_assert(std::is_base_of<RefCounted<typename Type::RefCountedType, CounterType>, Type>::value, "makeIntrusive<Type> needs Type to inherit from RefCounted");
+
+	IntrusiveBlock<Type, CounterType>* block = IntrusiveBlock<Type, CounterType>::create(std::forward<ArgTypes>(args)...);
+	return IntrusivePtr<Type, CounterType>(block->get());
 }
 
-template<typename Type, typename DeleterType>
-inline Type* agm::UniquePtr<Type, DeleterType>::operator ->(){
-	return this->get();
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::staticCast(const agm::SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	ReturnType* otherObj = static_cast<ReturnType*>(ptr.get());
+	SharedPtr<ReturnType, DeleterType, CounterType> outPtr(ptr, otherObj);
+	return outPtr;
 }
 
-template<typename Type, typename DeleterType>
-inline Type* agm::UniquePtr<Type, DeleterType>::operator ->() const{
-	return this->get();
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::dynamicCast(const agm::SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	if(ReturnType* otherObj = dynamic_cast<ReturnType*>(ptr.get())){
+		return SharedPtr<ReturnType, DeleterType, CounterType>(ptr, otherObj);
+	}
+	return SharedPtr<ReturnType, DeleterType, CounterType>();
 }
 
-template<typename Type, typename DeleterType>
-inline Type& agm::UniquePtr<Type, DeleterType>::operator *(){
-	return *this->get();
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::constCast(const agm::SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	ReturnType* otherObj = const_cast<ReturnType*>(ptr.get());
+	SharedPtr<ReturnType, DeleterType, CounterType> outPtr(ptr, otherObj);
+	return outPtr;
 }
 
-template<typename Type, typename DeleterType>
-inline Type& agm::UniquePtr<Type, DeleterType>::operator *() const{
-	return *this->get();
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::reinterpretCast(const agm::SharedPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	ReturnType* otherObj = reinterpret_cast<ReturnType*>(ptr.get());
+	SharedPtr<ReturnType, DeleterType, CounterType> outPtr(ptr, otherObj);
+	return outPtr;
 }
 
-template<typename Type, typename DeleterType>
-inline agm::UniquePtr<Type, DeleterType>& agm::UniquePtr<Type, DeleterType>::operator =(agm::UniquePtr<Type, DeleterType>&& ptr){
-	if(this != &ptr){
-		if(this->isValid()){
-			free();
-		}
-		this->object = ptr.object;
-		ptr.object = nullptr;
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::staticCast(agm::SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
+	ReturnType* otherObj = static_cast<ReturnType*>(ptr.get());
+	return SharedPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
+}
+
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::dynamicCast(agm::SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
+	if(ReturnType* otherObj = dynamic_cast<ReturnType*>(ptr.get())){
+		return SharedPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
 	}
-	return *this;
+	return SharedPtr<ReturnType, DeleterType, CounterType>();
 }
 
-template<typename Type, typename DeleterType>
-inline void agm::UniquePtr<Type, DeleterType>::free(){
-	if(this->isValid()){
-		this->deleter(this->get());
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::constCast(agm::SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
+	ReturnType* otherObj = const_cast<ReturnType*>(ptr.get());
+	return SharedPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
+}
+
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::SharedPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::reinterpretCast(agm::SharedPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
+	ReturnType* otherObj = reinterpret_cast<ReturnType*>(ptr.get());
+	return SharedPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
+}
+
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::staticCast(const agm::WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	ReturnType* otherObj = static_cast<ReturnType*>(ptr.get());
+	return WeakPtr<ReturnType, DeleterType, CounterType>(ptr, otherObj);
+}
+
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::dynamicCast(const agm::WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	SharedPtr<CurrentType, DeleterType, CounterType> pinned(ptr);
+	if(ReturnType* otherObj = dynamic_cast<ReturnType*>(pinned.get())){
+		return WeakPtr<ReturnType, DeleterType, CounterType>(ptr, otherObj);
 	}
-	this->object = nullptr;
+	return WeakPtr<ReturnType, DeleterType, CounterType>();
 }
 
-/////////HELPER FUNCTIONS
-template<typename Type>
-agm::UniquePtr<Type> agm::makeUnique(Type* object){
-	return UniquePtr<Type>(object);
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::constCast(const agm::WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	ReturnType* otherObj = const_cast<ReturnType*>(ptr.get());
+	return WeakPtr<ReturnType, DeleterType, CounterType>(ptr, otherObj);
 }
 
-template<typename Type>
-agm::SharedPtr<Type> agm::makeShared(Type* object){
-	return SharedPtr<Type>(object);
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::reinterpretCast(const agm::WeakPtr<CurrentType, DeleterType, CounterType>& ptr) noexcept{
+	ReturnType* otherObj = reinterpret_cast<ReturnType*>(ptr.get());
+	return WeakPtr<ReturnType, DeleterType, CounterType>(ptr, otherObj);
 }
 
-template<typename ReturnType, typename CurrentType>
-agm::SharedPtr<ReturnType> agm::staticCast(const agm::SharedPtr<CurrentType>& ptr){
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::staticCast(agm::WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
 	ReturnType* otherObj = static_cast<ReturnType*>(ptr.get());
-	SharedPtr<ReturnType> outPtr(ptr, otherObj);
-	return outPtr;
+	return WeakPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
 }
 
-template<typename ReturnType, typename CurrentType>
-agm::SharedPtr<ReturnType> agm::dynamicCast(const agm::SharedPtr<CurrentType>& ptr){
-	if(ReturnType* otherObj = dynamic_cast<ReturnType*>(ptr.get())){
-		return SharedPtr<ReturnType>(ptr, otherObj);
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::dynamicCast(agm::WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
+	SharedPtr<CurrentType, DeleterType, CounterType> pinned(ptr);
+	if(ReturnType* otherObj = dynamic_cast<ReturnType*>(pinned.get())){
+		return WeakPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
 	}
-	return SharedPtr<ReturnType>();
+	return WeakPtr<ReturnType, DeleterType, CounterType>();
 }
 
-template<typename ReturnType, typename CurrentType>
-agm::SharedPtr<ReturnType> agm::constCast(const agm::SharedPtr<CurrentType>& ptr){
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::constCast(agm::WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
 	ReturnType* otherObj = const_cast<ReturnType*>(ptr.get());
-	SharedPtr<ReturnType> outPtr(ptr, otherObj);
-	return outPtr;
+	return WeakPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
 }
 
-template<typename ReturnType, typename CurrentType>
-agm::SharedPtr<ReturnType> agm::reinterpretCast(const agm::SharedPtr<CurrentType>& ptr){
+template<typename ReturnType, typename CurrentType, typename DeleterType, typename CounterType>
+agm::WeakPtr<ReturnType, DeleterType, CounterType> agm::AGM_ABI_NAMESPACE::reinterpretCast(agm::WeakPtr<CurrentType, DeleterType, CounterType>&& ptr) noexcept{
 	ReturnType* otherObj = reinterpret_cast<ReturnType*>(ptr.get());
-	SharedPtr<ReturnType> outPtr(ptr, otherObj);
-	return outPtr;
+	return WeakPtr<ReturnType, DeleterType, CounterType>(std::move(ptr), otherObj);
+}
+
+template<typename ReturnType, typename CurrentType, typename DeleterType>
+agm::UniquePtr<ReturnType, DeleterType> agm::AGM_ABI_NAMESPACE::staticCast(agm::UniquePtr<CurrentType, DeleterType>&& ptr) noexcept{
+	static_assert(std::is_same<std::remove_cv_t<ReturnType>, std::remove_cv_t<CurrentType>>::value || std::has_virtual_destructor<ReturnType>::value, "The cast UniquePtr deletes the object through ReturnType, which needs a virtual destructor");
+
+	ReturnType* otherObj = static_cast<ReturnType*>(ptr.get());
+	return UniquePtr<ReturnType, DeleterType>(std::move(ptr), otherObj);
+}
+
+template<typename ReturnType, typename CurrentType, typename DeleterType>
+agm::UniquePtr<ReturnType, DeleterType> agm::AGM_ABI_NAMESPACE::dynamicCast(agm::UniquePtr<CurrentType, DeleterType>&& ptr) noexcept{
+	static_assert(std::has_virtual_destructor<ReturnType>::value, "The cast UniquePtr deletes the object through ReturnType, which needs a virtual destructor");
+
+	if(ReturnType* otherObj = dynamic_cast<ReturnType*>(ptr.get())){
+		return UniquePtr<ReturnType, DeleterType>(std::move(ptr), otherObj);
+	}
+	return UniquePtr<ReturnType, DeleterType>();
+}
+
+template<typename ReturnType, typename CurrentType, typename DeleterType>
+agm::UniquePtr<ReturnType, DeleterType> agm::AGM_ABI_NAMESPACE::constCast(agm::UniquePtr<CurrentType, DeleterType>&& ptr) noexcept{
+	ReturnType* otherObj = const_cast<ReturnType*>(ptr.get());
+	return UniquePtr<ReturnType, DeleterType>(std::move(ptr), otherObj);
 }
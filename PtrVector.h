@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <type_traits>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////PTR VECTOR
+	//A vector for trivially relocatable types, mainly the pointers in Ptr.h. Growing, inserting and erasing move the
+	//elements with realloc / memmove instead of constructing and destroying each one, so reallocating a vector of
+	//SharedPtrs costs a memmove instead of a grab() and release() per element.
+	//Other types are moved one element at a time like std::vector does, so their moves can't throw
+	template<typename PtrType>
+	class PtrVector{
+		static_assert(IsTriviallyRelocatable<PtrType>::value || (std::is_nothrow_move_constructible<PtrType>::value && std::is_nothrow_move_assignable<PtrType>::value),
+			"PtrVector can only hold types that are trivially relocatable or can be moved without throwing");
+		static_assert(alignof(PtrType) <= alignof(std::max_align_t), "PtrVector allocates with malloc, which only guarantees max_align_t");
+
+		//VARIABLES
+	private:
+		static constexpr std::size_t minCapacity = 8;
+		static constexpr bool relocatable = IsTriviallyRelocatable<PtrType>::value;
+
+		PtrType* elements = nullptr;
+		std::size_t count = 0;
+		std::size_t capacity = 0;
+
+		//FUNCTIONS
+	public:
+		constexpr PtrVector() noexcept = default;
+
+		PtrVector(const PtrVector<PtrType>& other);
+		PtrVector(PtrVector<PtrType>&& other) noexcept;
+
+		~PtrVector();
+
+		PtrVector<PtrType>& operator =(const PtrVector<PtrType>& other);
+		PtrVector<PtrType>& operator =(PtrVector<PtrType>&& other) noexcept;
+
+		void pushBack(const PtrType& value);
+		void pushBack(PtrType&& value);
+		template<typename... ArgTypes> PtrType& emplaceBack(ArgTypes&&... args);
+		void popBack() noexcept;
+
+		//Shifts everything from index onwards up one place and moves value into the gap
+		void insert(std::size_t index, PtrType value);
+		//Destroys eraseCount elements starting at index and shifts the rest down to fill the gap
+		void erase(std::size_t index, std::size_t eraseCount = 1) noexcept;
+
+		void reserve(std::size_t inCapacity);
+		void clear() noexcept;
+
+		void swap(PtrVector<PtrType>& other) noexcept;
+
+		PtrType& operator [](std::size_t index) noexcept;
+		const PtrType& operator [](std::size_t index) const noexcept;
+
+		PtrType* data() noexcept;
+		const PtrType* data() const noexcept;
+
+		PtrType* begin() noexcept;
+		PtrType* end() noexcept;
+		const PtrType* begin() const noexcept;
+		const PtrType* end() const noexcept;
+
+		std::size_t size() const noexcept;
+		std::size_t getCapacity() const noexcept;
+		bool isEmpty() const noexcept;
+
+	private:
+		void grow();
+		void reallocate(std::size_t inCapacity);
+	};
+}
+}
+
+/////////INLINE INCLUDE
+#include "PtrVector.inl"
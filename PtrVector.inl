@@ -0,0 +1,214 @@
+#include <cstring>
+#include <new>
+#include <utility>
+
+/////////PTR VECTOR
+template<typename PtrType>
+inline agm::PtrVector<PtrType>::PtrVector(const agm::PtrVector<PtrType>& other){
+	reserve(other.count);
+	for(const PtrType& value : other){
+		new(elements + count) PtrType(value);
+		++count;
+	}
+}
+
+template<typename PtrType>
+inline agm::PtrVector<PtrType>::PtrVector(agm::PtrVector<PtrType>&& other) noexcept{
+	swap(other);
+}
+
+template<typename PtrType>
+inline agm::PtrVector<PtrType>::~PtrVector(){
+	clear();
+	std::free(static_cast<void*>(elements));
+}
+
+template<typename PtrType>
+inline agm::PtrVector<PtrType>& agm::PtrVector<PtrType>::operator =(const agm::PtrVector<PtrType>& other){
+	if(this != &other){
+		PtrVector<PtrType> copy(other);
+		swap(copy);
+	}
+	return *this;
+}
+
+template<typename PtrType>
+inline agm::PtrVector<PtrType>& agm::PtrVector<PtrType>::operator =(agm::PtrVector<PtrType>&& other) noexcept{
+	if(this != &other){
+		PtrVector<PtrType> moved(std::move(other));
+		swap(moved);
+	}
+	return *this;
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::pushBack(const PtrType& value){
+	emplaceBack(value);
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::pushBack(PtrType&& value){
+	emplaceBack(std::move(value));
+}
+
+template<typename PtrType>
+template<typename... ArgTypes>
+inline PtrType& agm::PtrVector<PtrType>::emplaceBack(ArgTypes&&... args){
+	if(count == capacity){
+		//The arguments may refer to an element, so build the new one before the storage moves
+		PtrType value(std::forward<ArgTypes>(args)...);
+		grow();
+		new(elements + count) PtrType(std::move(value));
+	} else{
+		new(elements + count) PtrType(std::forward<ArgTypes>(args)...);
+	}
+	return elements[count++];
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::popBack() noexcept{
+	elements[--count].~PtrType();
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::insert(std::size_t index, PtrType value){
+	if(count == capacity){
+		grow();
+	}
+	if constexpr(relocatable){
+		std::memmove(static_cast<void*>(elements + index + 1), static_cast<const void*>(elements + index), (count - index) * sizeof(PtrType));
+		new(elements + index) PtrType(std::move(value));
+	} else if(index == count){
+		new(elements + index) PtrType(std::move(value));
+	} else{
+		new(elements + count) PtrType(std::move(elements[count - 1]));
+		for(std::size_t i = count - 1; i > index; --i){
+			elements[i] = std::move(elements[i - 1]);
+		}
+		elements[index] = std::move(value);
+	}
+	++count;
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::erase(std::size_t index, std::size_t eraseCount) noexcept{
+	if constexpr(relocatable){
+		for(std::size_t i = index; i < index + eraseCount; ++i){
+			elements[i].~PtrType();
+		}
+		std::memmove(static_cast<void*>(elements + index), static_cast<const void*>(elements + index + eraseCount), (count - index - eraseCount) * sizeof(PtrType));
+		count -= eraseCount;
+	} else{
+		for(std::size_t i = index; i + eraseCount < count; ++i){
+			elements[i] = std::move(elements[i + eraseCount]);
+		}
+		for(std::size_t i = 0; i < eraseCount; ++i){
+			popBack();
+		}
+	}
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::reserve(std::size_t inCapacity){
+	if(inCapacity > capacity){
+		reallocate(inCapacity);
+	}
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::clear() noexcept{
+	while(count > 0){
+		popBack();
+	}
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::swap(agm::PtrVector<PtrType>& other) noexcept{
+	std::swap(elements, other.elements);
+	std::swap(count, other.count);
+	std::swap(capacity, other.capacity);
+}
+
+template<typename PtrType>
+inline PtrType& agm::PtrVector<PtrType>::operator [](std::size_t index) noexcept{
+	return elements[index];
+}
+
+template<typename PtrType>
+inline const PtrType& agm::PtrVector<PtrType>::operator [](std::size_t index) const noexcept{
+	return elements[index];
+}
+
+template<typename PtrType>
+inline PtrType* agm::PtrVector<PtrType>::data() noexcept{
+	return elements;
+}
+
+template<typename PtrType>
+inline const PtrType* agm::PtrVector<PtrType>::data() const noexcept{
+	return elements;
+}
+
+template<typename PtrType>
+inline PtrType* agm::PtrVector<PtrType>::begin() noexcept{
+	return elements;
+}
+
+template<typename PtrType>
+inline PtrType* agm::PtrVector<PtrType>::end() noexcept{
+	return elements + count;
+}
+
+template<typename PtrType>
+inline const PtrType* agm::PtrVector<PtrType>::begin() const noexcept{
+	return elements;
+}
+
+template<typename PtrType>
+inline const PtrType* agm::PtrVector<PtrType>::end() const noexcept{
+	return elements + count;
+}
+
+template<typename PtrType>
+inline std::size_t agm::PtrVector<PtrType>::size() const noexcept{
+	return count;
+}
+
+template<typename PtrType>
+inline std::size_t agm::PtrVector<PtrType>::getCapacity() const noexcept{
+	return capacity;
+}
+
+template<typename PtrType>
+inline bool agm::PtrVector<PtrType>::isEmpty() const noexcept{
+	return count == 0;
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::grow(){
+	reallocate(capacity < minCapacity ? minCapacity : capacity * 2);
+}
+
+template<typename PtrType>
+inline void agm::PtrVector<PtrType>::reallocate(std::size_t inCapacity){
+	if constexpr(relocatable){
+		//realloc can often extend the block in place, and when it can't it copies the bytes, which is all relocating needs
+		void* newElements = std::realloc(static_cast<void*>(elements), inCapacity * sizeof(PtrType));
+		if(!newElements){
+			throw std::bad_alloc();
+		}
+		elements = static_cast<PtrType*>(newElements);
+	} else{
+		PtrType* newElements = static_cast<PtrType*>(std::malloc(inCapacity * sizeof(PtrType)));
+		if(!newElements){
+			throw std::bad_alloc();
+		}
+		for(std::size_t i = 0; i < count; ++i){
+			new(newElements + i) PtrType(std::move(elements[i]));
+			elements[i].~PtrType();
+		}
+		std::free(static_cast<void*>(elements));
+		elements = newElements;
+	}
+	capacity = inCapacity;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////RECLAIM STATS
+	struct ReclaimStats{
+		//Objects waiting to be reclaimed, and the most there have ever been
+		std::size_t depth = 0;
+		std::size_t peakDepth = 0;
+
+		std::uint64_t deferred = 0;
+		std::uint64_t reclaimed = 0;
+		std::uint64_t batches = 0;
+
+		//Time between an object being deferred and it being destroyed
+		std::chrono::nanoseconds maxLatency{ 0 };
+		std::chrono::nanoseconds totalLatency{ 0 };
+
+		std::chrono::nanoseconds averageLatency() const;
+	};
+
+	/////////RECLAIM QUEUE
+	//Objects released with a DeferredDeleter are pushed here instead of being destroyed, then destroyed
+	//in batches by collect(). Pushing is a single CAS and collect() takes the whole queue in one exchange,
+	//so any number of threads can push while another thread collects without taking a lock
+	class ReclaimQueue{
+		//VARIABLES
+	private:
+		struct Node{
+			Node* next;
+			void (*reclaim)(void*);
+			void* target;
+			std::chrono::steady_clock::time_point deferredAt;
+		};
+
+		std::atomic<Node*> head{ nullptr };
+
+		std::atomic<std::size_t> depth{ 0 };
+		std::atomic<std::size_t> peakDepth{ 0 };
+		std::atomic<std::uint64_t> deferred{ 0 };
+		std::atomic<std::uint64_t> reclaimed{ 0 };
+		std::atomic<std::uint64_t> batches{ 0 };
+		std::atomic<std::int64_t> maxLatency{ 0 };
+		std::atomic<std::int64_t> totalLatency{ 0 };
+
+		//FUNCTIONS
+	public:
+		static ReclaimQueue& get();
+
+		void push(void (*reclaim)(void*), void* target);
+
+		//Destroys everything in the queue, including anything pushed by the destructors it runs.
+		//Returns how many objects were destroyed
+		std::size_t collect();
+
+		ReclaimStats getStats() const;
+
+	private:
+		ReclaimQueue() = default;
+
+		void recordLatency(std::int64_t latency);
+	};
+
+	/////////DEFERRED DELETER
+	//Use as the DeleterType of a SharedPtr / WeakPtr / UniquePtr to move the destructor off the thread that drops
+	//the last reference. The object is destroyed with delete on whichever thread calls agm::collect()
+	struct DeferredDeleter{
+		static void defer(void (*reclaim)(void*), void* target);
+
+		template<typename Type>
+		void operator ()(Type* ptr);
+	};
+
+	//Deferred arrays are destroyed with delete[] when they are collected
+	template<>
+	struct ArrayDeleterType<DeferredDeleter>{
+		typedef ArrayDeleter type;
+	};
+
+	/////////RECLAIM THREAD
+	//Calls collect() every interval on a background thread until it is destroyed, then collects one last time
+	class ReclaimThread{
+		//VARIABLES
+	private:
+		std::chrono::milliseconds interval;
+
+		std::mutex lock;
+		std::condition_variable wake;
+		bool running = true;
+
+		std::thread thread;
+
+		//FUNCTIONS
+	public:
+		explicit ReclaimThread(std::chrono::milliseconds inInterval = std::chrono::milliseconds(1));
+
+		ReclaimThread(const ReclaimThread& other) = delete;
+
+		~ReclaimThread();
+
+		ReclaimThread& operator =(const ReclaimThread& other) = delete;
+
+	private:
+		void run();
+	};
+
+	/////////HELPER FUNCTIONS
+	template<typename Type, typename CounterType = DefaultCounter, typename... ArgTypes>
+	SharedPtr<Type, DeferredDeleter, CounterType> makeSharedDeferred(ArgTypes&&... args);
+
+	std::size_t collect();
+	ReclaimStats getReclaimStats();
+}
+}
+
+/////////INLINE INCLUDE
+#include "Reclaim.inl"
@@ -0,0 +1,131 @@
+/////////RECLAIM STATS
+inline std::chrono::nanoseconds agm::ReclaimStats::averageLatency() const{
+	return reclaimed > 0 ? totalLatency / static_cast<std::int64_t>(reclaimed) : std::chrono::nanoseconds(0);
+}
+
+/////////RECLAIM QUEUE
+inline agm::ReclaimQueue& agm::ReclaimQueue::get(){
+	//Never destroyed so objects released during static destruction can still be deferred
+	static ReclaimQueue* queue = new ReclaimQueue();
+	return *queue;
+}
+
+inline void agm::ReclaimQueue::push(void (*reclaim)(void*), void* target){
+	Node* node = new Node{ nullptr, reclaim, target, std::chrono::steady_clock::now() };
+
+	node->next = head.load(std::memory_order_relaxed);
+	while(!head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)){
+	}
+
+	deferred.fetch_add(1, std::memory_order_relaxed);
+	const std::size_t newDepth = depth.fetch_add(1, std::memory_order_relaxed) + 1;
+	std::size_t peak = peakDepth.load(std::memory_order_relaxed);
+	while(newDepth > peak && !peakDepth.compare_exchange_weak(peak, newDepth, std::memory_order_relaxed)){
+	}
+}
+
+inline std::size_t agm::ReclaimQueue::collect(){
+	std::size_t count = 0;
+
+	//Destructors can defer more objects, so keep going until the queue stays empty
+	while(Node* batch = head.exchange(nullptr, std::memory_order_acquire)){
+		//The queue is a stack, reverse it so objects are destroyed in the order they were released
+		Node* ordered = nullptr;
+		while(batch){
+			Node* next = batch->next;
+			batch->next = ordered;
+			ordered = batch;
+			batch = next;
+		}
+
+		std::size_t batchCount = 0;
+		while(ordered){
+			Node* node = ordered;
+			ordered = node->next;
+
+			depth.fetch_sub(1, std::memory_order_relaxed);
+			node->reclaim(node->target);
+			recordLatency(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - node->deferredAt).count());
+
+			delete node;
+			++batchCount;
+		}
+
+		reclaimed.fetch_add(batchCount, std::memory_order_relaxed);
+		batches.fetch_add(1, std::memory_order_relaxed);
+		count += batchCount;
+	}
+
+	return count;
+}
+
+inline agm::ReclaimStats agm::ReclaimQueue::getStats() const{
+	ReclaimStats stats;
+	stats.depth = depth.load(std::memory_order_relaxed);
+	stats.peakDepth = peakDepth.load(std::memory_order_relaxed);
+	stats.deferred = deferred.load(std::memory_order_relaxed);
+	stats.reclaimed = reclaimed.load(std::memory_order_relaxed);
+	stats.batches = batches.load(std::memory_order_relaxed);
+	stats.maxLatency = std::chrono::nanoseconds(maxLatency.load(std::memory_order_relaxed));
+	stats.totalLatency = std::chrono::nanoseconds(totalLatency.load(std::memory_order_relaxed));
+	return stats;
+}
+
+inline void agm::ReclaimQueue::recordLatency(std::int64_t latency){
+	totalLatency.fetch_add(latency, std::memory_order_relaxed);
+	std::int64_t currentMax = maxLatency.load(std::memory_order_relaxed);
+	while(latency > currentMax && !maxLatency.compare_exchange_weak(currentMax, latency, std::memory_order_relaxed)){
+	}
+}
+
+/////////DEFERRED DELETER
+inline void agm::DeferredDeleter::defer(void (*reclaim)(void*), void* target){
+	ReclaimQueue::get().push(reclaim, target);
+}
+
+template<typename Type>
+inline void agm::DeferredDeleter::operator ()(Type* ptr){
+	delete ptr;
+}
+
+/////////RECLAIM THREAD
+inline agm::ReclaimThread::ReclaimThread(std::chrono::milliseconds inInterval)
+	: interval(inInterval)
+	, thread(&ReclaimThread::run, this){
+}
+
+inline agm::ReclaimThread::~ReclaimThread(){
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		running = false;
+	}
+	wake.notify_one();
+	thread.join();
+
+	collect();
+}
+
+inline void agm::ReclaimThread::run(){
+	std::unique_lock<std::mutex> guard(lock);
+	while(running){
+		guard.unlock();
+		collect();
+		guard.lock();
+
+		wake.wait_for(guard, interval, [this](){ return !running; });
+	}
+}
+
+/////////HELPER FUNCTIONS
+template<typename Type, typename CounterType, typename... ArgTypes>
+agm::SharedPtr<Type, agm::DeferredDeleter, CounterType> agm::AGM_ABI_NAMESPACE::makeSharedDeferred(ArgTypes&&... args){
+	return SharedPtr<Type, DeferredDeleter, CounterType>(new Type(std::forward<ArgTypes>(args)...));
+}
+
+inline std::size_t agm::AGM_ABI_NAMESPACE::collect(){
+	return ReclaimQueue::get().collect();
+}
+
+inline agm::ReclaimStats agm::AGM_ABI_NAMESPACE::getReclaimStats(){
+	return ReclaimQueue::get().getStats();
+}
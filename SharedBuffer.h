@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <cstddef>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	template<typename CounterType> class BufferView;
+
+	/////////SHARED BUFFER
+	//Writable, reference counted block of bytes. makeSharedBuffer puts the bytes directly after the control block in a
+	//single allocation. Views and slices share the buffer's control block, so handing payloads between stages never
+	//copies the bytes, and the memory is freed when the buffer and the last view are gone
+	template<typename CounterType = DefaultCounter>
+	class SharedBuffer{
+		friend class BufferView<CounterType>;
+
+		//VARIABLES
+	private:
+		SharedPtr<std::byte[], DefaultDeleter, CounterType> bytes;
+
+		//FUNCTIONS
+	public:
+		explicit constexpr SharedBuffer() noexcept = default;
+		explicit SharedBuffer(SharedPtr<std::byte[], DefaultDeleter, CounterType> inBytes) noexcept;
+
+		std::byte* data() const noexcept;
+		std::size_t size() const noexcept;
+		bool isEmpty() const noexcept;
+
+		std::byte& operator [](std::size_t index) const noexcept;
+
+		std::byte* begin() const noexcept;
+		std::byte* end() const noexcept;
+
+		BufferView<CounterType> view() const noexcept;
+		//count is clamped to the end of the buffer
+		BufferView<CounterType> slice(std::size_t offset, std::size_t count = BufferView<CounterType>::npos) const noexcept;
+
+		void reset() noexcept;
+
+		explicit operator bool() const noexcept;
+	};
+
+	/////////BUFFER VIEW
+	//Read only slice of a SharedBuffer that keeps the whole buffer alive. It is an aliasing SharedPtr to the first byte
+	//of the slice plus a length, so copying one is a single reference count increment and moving one is free.
+	//Offsets past the end are clamped, or stop the program with AGM_CHECKED_ACCESS
+	template<typename CounterType = DefaultCounter>
+	class BufferView{
+		//VARIABLES
+	public:
+		static constexpr std::size_t npos = ~std::size_t(0);
+
+	private:
+		SharedPtr<const std::byte, DefaultDeleter, CounterType> bytes;
+		std::size_t length = 0;
+
+		//FUNCTIONS
+	public:
+		explicit constexpr BufferView() noexcept = default;
+
+		BufferView(const SharedBuffer<CounterType>& buffer) noexcept;
+		//Takes the buffer's reference instead of grabbing a new one
+		BufferView(SharedBuffer<CounterType>&& buffer) noexcept;
+
+		const std::byte* data() const noexcept;
+		std::size_t size() const noexcept;
+		bool isEmpty() const noexcept;
+
+		const std::byte& operator [](std::size_t index) const noexcept;
+
+		const std::byte* begin() const noexcept;
+		const std::byte* end() const noexcept;
+
+		BufferView<CounterType> slice(std::size_t offset, std::size_t count = npos) const & noexcept;
+		BufferView<CounterType> slice(std::size_t offset, std::size_t count = npos) && noexcept;
+
+		//Shrink the view in place, without touching the reference count
+		void removePrefix(std::size_t count) noexcept;
+		void removeSuffix(std::size_t count) noexcept;
+
+		//True if both views keep the same buffer alive, even when they don't overlap
+		bool sharesBuffer(const BufferView<CounterType>& other) const noexcept;
+
+		void reset() noexcept;
+
+		explicit operator bool() const noexcept;
+
+	private:
+		BufferView(SharedPtr<const std::byte, DefaultDeleter, CounterType>&& inBytes, std::size_t inLength) noexcept;
+
+		//Clamps offset to the view, or stops the program with AGM_CHECKED_ACCESS
+		std::size_t clampOffset(std::size_t offset, const char* function) const noexcept;
+	};
+
+	/////////TRIVIALLY RELOCATABLE
+	template<typename CounterType>
+	struct IsTriviallyRelocatable<SharedBuffer<CounterType>> : std::true_type{
+	};
+	template<typename CounterType>
+	struct IsTriviallyRelocatable<BufferView<CounterType>> : std::true_type{
+	};
+
+	/////////HELPER FUNCTIONS
+	template<typename CounterType = DefaultCounter>
+	SharedBuffer<CounterType> makeSharedBuffer(std::size_t size);
+	template<typename CounterType = DefaultCounter>
+	SharedBuffer<CounterType> makeSharedBufferUninitialised(std::size_t size);
+	//The only function here that copies bytes, for wrapping data that didn't come from a SharedBuffer
+	template<typename CounterType = DefaultCounter>
+	SharedBuffer<CounterType> copySharedBuffer(const void* source, std::size_t size);
+}
+}
+
+/////////INLINE INCLUDE
+#include "SharedBuffer.inl"
@@ -0,0 +1,183 @@
+/////////SHARED BUFFER
+template<typename CounterType>
+inline agm::SharedBuffer<CounterType>::SharedBuffer(SharedPtr<std::byte[], DefaultDeleter, CounterType> inBytes) noexcept
+	: bytes(std::move(inBytes)){
+}
+
+template<typename CounterType>
+inline std::byte* agm::SharedBuffer<CounterType>::data() const noexcept{
+	return bytes.get();
+}
+
+template<typename CounterType>
+inline std::size_t agm::SharedBuffer<CounterType>::size() const noexcept{
+	return bytes.size();
+}
+
+template<typename CounterType>
+inline bool agm::SharedBuffer<CounterType>::isEmpty() const noexcept{
+	return bytes.size() == 0;
+}
+
+template<typename CounterType>
+inline std::byte& agm::SharedBuffer<CounterType>::operator [](std::size_t index) const noexcept{
+	return bytes[index];
+}
+
+template<typename CounterType>
+inline std::byte* agm::SharedBuffer<CounterType>::begin() const noexcept{
+	return bytes.get();
+}
+
+template<typename CounterType>
+inline std::byte* agm::SharedBuffer<CounterType>::end() const noexcept{
+	return bytes.get() + bytes.size();
+}
+
+template<typename CounterType>
+inline agm::BufferView<CounterType> agm::SharedBuffer<CounterType>::view() const noexcept{
+	return BufferView<CounterType>(*this);
+}
+
+template<typename CounterType>
+inline agm::BufferView<CounterType> agm::SharedBuffer<CounterType>::slice(std::size_t offset, std::size_t count) const noexcept{
+	return view().slice(offset, count);
+}
+
+template<typename CounterType>
+inline void agm::SharedBuffer<CounterType>::reset() noexcept{
+	bytes.reset();
+}
+
+template<typename CounterType>
+inline agm::SharedBuffer<CounterType>::operator bool() const noexcept{
+	return static_cast<bool>(bytes);
+}
+
+/////////BUFFER VIEW
+template<typename CounterType>
+inline agm::BufferView<CounterType>::BufferView(const SharedBuffer<CounterType>& buffer) noexcept
+	: bytes(buffer.bytes, buffer.data())
+	, length(buffer.size()){
+}
+
+template<typename CounterType>
+inline agm::BufferView<CounterType>::BufferView(SharedBuffer<CounterType>&& buffer) noexcept
+	: length(buffer.size()){
+	bytes = SharedPtr<const std::byte, DefaultDeleter, CounterType>(std::move(buffer.bytes), buffer.data());
+	buffer.reset();
+}
+
+template<typename CounterType>
+inline agm::BufferView<CounterType>::BufferView(SharedPtr<const std::byte, DefaultDeleter, CounterType>&& inBytes, std::size_t inLength) noexcept
+	: bytes(std::move(inBytes))
+	, length(inLength){
+}
+
+template<typename CounterType>
+inline const std::byte* agm::BufferView<CounterType>::data() const noexcept{
+	return bytes.get();
+}
+
+template<typename CounterType>
+inline std::size_t agm::BufferView<CounterType>::size() const noexcept{
+	return length;
+}
+
+template<typename CounterType>
+inline bool agm::BufferView<CounterType>::isEmpty() const noexcept{
+	return length == 0;
+}
+
+template<typename CounterType>
+inline const std::byte& agm::BufferView<CounterType>::operator [](std::size_t index) const noexcept{
+	if constexpr(checkedAccess){
+		if(index >= length){
+			accessFailure("an out of range", AGM_FUNCTION_NAME);
+		}
+	}
+	return bytes.get()[index];
+}
+
+template<typename CounterType>
+inline const std::byte* agm::BufferView<CounterType>::begin() const noexcept{
+	return bytes.get();
+}
+
+template<typename CounterType>
+inline const std::byte* agm::BufferView<CounterType>::end() const noexcept{
+	return bytes.get() + length;
+}
+
+template<typename CounterType>
+inline agm::BufferView<CounterType> agm::BufferView<CounterType>::slice(std::size_t offset, std::size_t count) const & noexcept{
+	const std::size_t start = clampOffset(offset, AGM_FUNCTION_NAME);
+	return BufferView<CounterType>(SharedPtr<const std::byte, DefaultDeleter, CounterType>(bytes, bytes.get() + start), std::min(count, length - start));
+}
+
+template<typename CounterType>
+inline agm::BufferView<CounterType> agm::BufferView<CounterType>::slice(std::size_t offset, std::size_t count) && noexcept{
+	const std::size_t start = clampOffset(offset, AGM_FUNCTION_NAME);
+	const std::size_t sliceLength = std::min(count, length - start);
+	length = 0;
+	return BufferView<CounterType>(SharedPtr<const std::byte, DefaultDeleter, CounterType>(std::move(bytes), bytes.get() + start), sliceLength);
+}
+
+template<typename CounterType>
+inline void agm::BufferView<CounterType>::removePrefix(std::size_t count) noexcept{
+	const std::size_t start = clampOffset(count, AGM_FUNCTION_NAME);
+	bytes = SharedPtr<const std::byte, DefaultDeleter, CounterType>(std::move(bytes), bytes.get() + start);
+	length -= start;
+}
+
+template<typename CounterType>
+inline void agm::BufferView<CounterType>::removeSuffix(std::size_t count) noexcept{
+	length -= clampOffset(count, AGM_FUNCTION_NAME);
+}
+
+template<typename CounterType>
+inline bool agm::BufferView<CounterType>::sharesBuffer(const BufferView<CounterType>& other) const noexcept{
+	return bytes && bytes.ownerEquals(other.bytes);
+}
+
+template<typename CounterType>
+inline void agm::BufferView<CounterType>::reset() noexcept{
+	bytes.reset();
+	length = 0;
+}
+
+template<typename CounterType>
+inline agm::BufferView<CounterType>::operator bool() const noexcept{
+	return static_cast<bool>(bytes);
+}
+
+template<typename CounterType>
+inline std::size_t agm::BufferView<CounterType>::clampOffset(std::size_t offset, const char* function) const noexcept{
+	if(offset > length){
+		if constexpr(checkedAccess){
+			accessFailure("an out of range", function);
+		}
+		return length;
+	}
+	return offset;
+}
+
+/////////HELPER FUNCTIONS
+template<typename CounterType>
+inline agm::SharedBuffer<CounterType> agm::AGM_ABI_NAMESPACE::makeSharedBuffer(std::size_t size){
+	return SharedBuffer<CounterType>(makeSharedArray<std::byte, CounterType>(size));
+}
+
+template<typename CounterType>
+inline agm::SharedBuffer<CounterType> agm::AGM_ABI_NAMESPACE::makeSharedBufferUninitialised(std::size_t size){
+	return SharedBuffer<CounterType>(makeSharedArrayUninitialised<std::byte, CounterType>(size));
+}
+
+template<typename CounterType>
+inline agm::SharedBuffer<CounterType> agm::AGM_ABI_NAMESPACE::copySharedBuffer(const void* source, std::size_t size){
+	SharedBuffer<CounterType> buffer = makeSharedBufferUninitialised<CounterType>(size);
+	if(size > 0){
+		std::memcpy(buffer.data(), source, size);
+	}
+	return buffer;
+}
@@ -0,0 +1,193 @@
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <stdexcept>
+#include <utility>
+
+/////////TYPES
+static int liveCount = 0;
+//Counts down with every Element made, the one that takes it to zero throws
+static int throwAfter = -1;
+
+struct Element{
+	int value = 7;
+
+	Element(){
+		if(throwAfter >= 0 && throwAfter-- == 0){
+			throw std::runtime_error("element");
+		}
+		++liveCount;
+	}
+	~Element(){ --liveCount; }
+};
+
+//Each array of cells is only owned by the array before it, so assigning a cell's next to the pointer that owns the
+//cell releases next as well
+template<typename CounterType>
+struct SharedCell{
+	agm::SharedPtr<SharedCell<CounterType>[], agm::DefaultDeleter, CounterType> next;
+	int value = 0;
+};
+
+struct UniqueCell{
+	agm::UniquePtr<UniqueCell[]> next;
+	int value = 0;
+};
+
+//Counts how often it is called, to see that adopted arrays go through the deleter
+struct CountingArrayDeleter{
+	int* calls = nullptr;
+
+	template<typename Type>
+	void operator ()(Type* ptr){
+		++*calls;
+		delete[] ptr;
+	}
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testMakeShared(){
+	typedef agm::SharedPtr<Element[], agm::DefaultDeleter, CounterType> ElementArray;
+
+	{
+		ElementArray elements = agm::makeSharedArray<Element, CounterType>(5);
+		CHECK(elements.size() == 5);
+		CHECK(liveCount == 5);
+		bool allDefault = true;
+		for(std::size_t i = 0; i < elements.size(); ++i){
+			allDefault = allDefault && elements[i].value == 7;
+		}
+		CHECK(allDefault);
+
+		//Copies share the elements
+		ElementArray copy = elements;
+		elements.reset();
+		CHECK(!elements);
+		CHECK(elements.size() == 0);
+		CHECK(liveCount == 5);
+		copy[4].value = 1;
+		CHECK(copy[4].value == 1);
+	}
+	CHECK(liveCount == 0);
+
+	agm::SharedPtr<int[], agm::DefaultDeleter, CounterType> zeroed = agm::makeSharedArray<int, CounterType>(4);
+	CHECK(zeroed[0] == 0 && zeroed[3] == 0);
+
+	agm::SharedPtr<int[], agm::DefaultDeleter, CounterType> uninitialised = agm::makeSharedArrayUninitialised<int, CounterType>(4);
+	CHECK(uninitialised.size() == 4);
+	uninitialised[3] = 9;
+	CHECK(uninitialised[3] == 9);
+
+	CHECK(agm::makeSharedArray<Element, CounterType>(0).size() == 0);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testThrowingElement(){
+	//The elements already built are destroyed again and nothing leaks
+	throwAfter = 3;
+	bool threw = false;
+	try{
+		agm::makeSharedArray<Element, CounterType>(5);
+	} catch(const std::runtime_error&){
+		threw = true;
+	}
+	throwAfter = -1;
+	CHECK(threw);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testSharedDeleter(){
+	int calls = 0;
+	{
+		agm::SharedPtr<Element[], CountingArrayDeleter, CounterType> adopted(new Element[3], 3, CountingArrayDeleter{ &calls });
+		agm::SharedPtr<Element[], CountingArrayDeleter, CounterType> copy = adopted;
+		adopted.reset();
+		CHECK(calls == 0);
+		CHECK(copy.size() == 3);
+	}
+	CHECK(calls == 1);
+
+	//DefaultDeleter becomes delete[]
+	{
+		agm::SharedPtr<Element[], agm::DefaultDeleter, CounterType> adopted(new Element[2], 2);
+		CHECK(liveCount == 2);
+	}
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testSharedOwnNext(){
+	typedef agm::SharedPtr<SharedCell<CounterType>[], agm::DefaultDeleter, CounterType> CellArray;
+
+	CellArray cells = agm::makeSharedArray<SharedCell<CounterType>, CounterType>(2);
+	cells[1].next = agm::makeSharedArray<SharedCell<CounterType>, CounterType>(3);
+	cells[1].next[0].value = 1;
+	cells[1].next[0].next = agm::makeSharedArray<SharedCell<CounterType>, CounterType>(1);
+
+	cells = std::move(cells[1].next);
+	CHECK(cells.size() == 3);
+	CHECK(cells[0].value == 1);
+
+	cells = cells[0].next;
+	CHECK(cells.size() == 1);
+}
+
+static void testMakeUnique(){
+	{
+		agm::UniquePtr<Element[]> elements = agm::makeUniqueArray<Element>(4);
+		CHECK(elements.size() == 4);
+		CHECK(liveCount == 4);
+		CHECK(elements[3].value == 7);
+
+		agm::UniquePtr<Element[]> moved = std::move(elements);
+		CHECK(!elements);
+		CHECK(moved.size() == 4);
+	}
+	CHECK(liveCount == 0);
+
+	agm::UniquePtr<int[]> zeroed = agm::makeUniqueArray<int>(3);
+	CHECK(zeroed[0] == 0 && zeroed[2] == 0);
+	agm::UniquePtr<int[]> uninitialised = agm::makeUniqueArrayUninitialised<int>(3);
+	uninitialised[2] = 5;
+	CHECK(uninitialised[2] == 5);
+
+	int calls = 0;
+	{
+		agm::UniquePtr<Element[], CountingArrayDeleter> adopted(new Element[2], 2, CountingArrayDeleter{ &calls });
+		agm::UniquePtr<Element[], CountingArrayDeleter> moved = adopted.move();
+		CHECK(moved.getDeleter().calls == &calls);
+	}
+	CHECK(calls == 1);
+	CHECK(liveCount == 0);
+
+	agm::UniquePtr<UniqueCell[]> cells = agm::makeUniqueArray<UniqueCell>(2);
+	cells[0].next = agm::makeUniqueArray<UniqueCell>(3);
+	cells[0].next[2].value = 4;
+	cells = std::move(cells[0].next);
+	CHECK(cells.size() == 3);
+	CHECK(cells[2].value == 4);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testMakeShared<CounterType>();
+	testThrowingElement<CounterType>();
+	testSharedDeleter<CounterType>();
+	testSharedOwnNext<CounterType>();
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	testMakeUnique();
+
+	return test::result();
+}
@@ -0,0 +1,137 @@
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <utility>
+
+/////////TYPES
+static int liveCount = 0;
+
+//A list where each node is only owned by the one before it, so assigning a node's next to the pointer that owns the
+//node releases the node, and the pointer being assigned from with it
+template<typename CounterType>
+struct Node{
+	typedef agm::SharedPtr<Node<CounterType>, agm::DefaultDeleter, CounterType> NodePtr;
+
+	int value;
+	NodePtr next;
+
+	explicit Node(int inValue) : value(inValue){ ++liveCount; }
+	~Node(){ --liveCount; }
+};
+
+template<typename CounterType>
+struct WeakNode{
+	int value;
+	agm::WeakPtr<WeakNode<CounterType>, agm::DefaultDeleter, CounterType> next;
+
+	explicit WeakNode(int inValue) : value(inValue){ ++liveCount; }
+	~WeakNode(){ --liveCount; }
+};
+
+struct UniqueNode{
+	int value;
+	agm::UniquePtr<UniqueNode> next;
+
+	explicit UniqueNode(int inValue) : value(inValue){ ++liveCount; }
+	~UniqueNode(){ --liveCount; }
+};
+
+/////////TESTS
+template<typename CounterType>
+static typename Node<CounterType>::NodePtr makeList(int length){
+	typename Node<CounterType>::NodePtr head;
+	for(int i = length; i > 0; --i){
+		typename Node<CounterType>::NodePtr node = agm::makeShared<Node<CounterType>, CounterType>(i);
+		node->next = std::move(head);
+		head = std::move(node);
+	}
+	return head;
+}
+
+template<typename CounterType>
+static void testSharedOwnNext(){
+	typename Node<CounterType>::NodePtr head = makeList<CounterType>(4);
+	CHECK(liveCount == 4);
+
+	head = std::move(head->next);
+	CHECK(head->value == 2);
+	CHECK(liveCount == 3);
+
+	head = head->next;
+	CHECK(head->value == 3);
+	CHECK(liveCount == 2);
+
+	//Aliasing the last node keeps it alive through the assignment
+	head = typename Node<CounterType>::NodePtr(head->next, head->next.get());
+	CHECK(head->value == 4);
+	CHECK(liveCount == 1);
+
+	head = head->next;
+	CHECK(!head);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testWeakOwnNext(){
+	typedef agm::SharedPtr<WeakNode<CounterType>, agm::DefaultDeleter, CounterType> WeakNodePtr;
+
+	WeakNodePtr second = agm::makeShared<WeakNode<CounterType>, CounterType>(2);
+	WeakNodePtr head = agm::makeShared<WeakNode<CounterType>, CounterType>(1);
+	head->next = second;
+
+	//Pinning the WeakPtr held by the node being released
+	head = head->next;
+	CHECK(head.get() == second.get());
+	CHECK(liveCount == 1);
+
+	agm::WeakPtr<WeakNode<CounterType>, agm::DefaultDeleter, CounterType> weak = head;
+	weak = second;
+	CHECK(weak.get() == second.get());
+	agm::WeakPtr<WeakNode<CounterType>, agm::DefaultDeleter, CounterType> other;
+	other = std::move(weak);
+	CHECK(!weak.get());
+	CHECK(other.get() == second.get());
+
+	head.reset();
+	second.reset();
+	CHECK(liveCount == 0);
+}
+
+static void testUniqueOwnNext(){
+	agm::UniquePtr<UniqueNode> head(new UniqueNode(1));
+	head->next = agm::UniquePtr<UniqueNode>(new UniqueNode(2));
+	head->next->next = agm::UniquePtr<UniqueNode>(new UniqueNode(3));
+
+	head = std::move(head->next);
+	CHECK(head->value == 2);
+	CHECK(liveCount == 2);
+
+	head = std::move(head->next);
+	CHECK(head->value == 3);
+	CHECK(liveCount == 1);
+
+	head = std::move(head->next);
+	CHECK(!head);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testSharedOwnNext<CounterType>();
+	if constexpr(!agm::IsStrongOnly<CounterType>::value){
+		testWeakOwnNext<CounterType>();
+	}
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	testUniqueOwnNext();
+
+	return test::result();
+}
@@ -0,0 +1,182 @@
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/////////TYPES
+static std::atomic<int> liveCount{ 0 };
+
+struct Counted{
+	int value;
+	//Always value * 2, a reader that sees anything else has read a destroyed or half built object
+	int twice;
+
+	explicit Counted(int inValue) : value(inValue), twice(inValue * 2){ ++liveCount; }
+	~Counted(){
+		twice = -1;
+		--liveCount;
+	}
+};
+
+typedef agm::SharedPtr<Counted, agm::DefaultDeleter, agm::AtomicCounter> CountedPtr;
+typedef agm::AtomicSharedPtr<Counted> AtomicCountedPtr;
+
+/////////TESTS
+static void testLoadStore(){
+	{
+		AtomicCountedPtr atomic;
+		CHECK(!atomic.load());
+		CHECK(!atomic.loadWeak().pin());
+		CHECK(atomic.isLockFree());
+
+		CountedPtr first = agm::makeShared<Counted, agm::AtomicCounter>(1);
+		atomic.store(first);
+		CHECK(atomic.load().get() == first.get());
+		CHECK(CountedPtr(atomic).get() == first.get());
+
+		//The AtomicSharedPtr keeps its own reference
+		Counted* held = first.get();
+		first.reset();
+		CHECK(liveCount == 1);
+		CHECK(atomic.load().get() == held);
+		CHECK(atomic.loadWeak().pin().get() == held);
+
+		atomic = agm::makeShared<Counted, agm::AtomicCounter>(2);
+		CHECK(liveCount == 1);
+		CHECK(atomic.load()->value == 2);
+
+		atomic.store(CountedPtr());
+		CHECK(!atomic.load());
+		CHECK(liveCount == 0);
+
+		AtomicCountedPtr constructed(agm::makeShared<Counted, agm::AtomicCounter>(3));
+		CHECK(constructed.load()->value == 3);
+	}
+	CHECK(liveCount == 0);
+}
+
+static void testExchange(){
+	AtomicCountedPtr atomic(agm::makeShared<Counted, agm::AtomicCounter>(1));
+
+	CountedPtr old = atomic.exchange(agm::makeShared<Counted, agm::AtomicCounter>(2));
+	CHECK(old->value == 1);
+	CHECK(atomic.load()->value == 2);
+	CHECK(liveCount == 2);
+
+	//A load still holding the old snapshot's value doesn't stop it being handed back
+	CountedPtr loaded = atomic.load();
+	old = atomic.exchange(CountedPtr());
+	CHECK(old.get() == loaded.get());
+	CHECK(!atomic.load());
+
+	CHECK(!atomic.exchange(CountedPtr()));
+	old.reset();
+	loaded.reset();
+	CHECK(liveCount == 0);
+}
+
+static void testCompareExchange(){
+	AtomicCountedPtr atomic;
+
+	//An empty expected matches an empty pointer
+	CountedPtr expected;
+	CHECK(atomic.compareExchange(expected, agm::makeShared<Counted, agm::AtomicCounter>(1)));
+	CHECK(atomic.load()->value == 1);
+
+	//A mismatch hands back what is held and leaves it in place
+	CHECK(!atomic.compareExchange(expected, agm::makeShared<Counted, agm::AtomicCounter>(2)));
+	CHECK(expected.get() == atomic.load().get());
+	CHECK(expected->value == 1);
+	CHECK(liveCount == 1);
+
+	CHECK(atomic.compareExchange(expected, agm::makeShared<Counted, agm::AtomicCounter>(3)));
+	CHECK(atomic.load()->value == 3);
+	expected.reset();
+	CHECK(liveCount == 1);
+
+	//An aliasing pointer shares the control block but not the object, so it doesn't match
+	CountedPtr current = atomic.load();
+	agm::SharedPtr<int, agm::DefaultDeleter, agm::AtomicCounter> member(current, &current->value);
+	CountedPtr aliased(current, reinterpret_cast<Counted*>(&current->twice));
+	CHECK(aliased.ownerEquals(current));
+	CHECK(!atomic.compareExchange(aliased, CountedPtr()));
+	CHECK(aliased.get() == current.get());
+	CHECK(atomic.load().get() == current.get());
+
+	CHECK(atomic.compareExchange(current, CountedPtr()));
+	CHECK(!atomic.load());
+	current.reset();
+	aliased.reset();
+	member.reset();
+	CHECK(liveCount == 0);
+}
+
+//Readers load and check the object while writers replace it, some with store and some with compareExchange
+static void testThreads(){
+	constexpr int readers = 4;
+	constexpr int writers = 2;
+	constexpr int increments = 2000;
+
+	{
+		AtomicCountedPtr atomic(agm::makeShared<Counted, agm::AtomicCounter>(0));
+		AtomicCountedPtr scratch;
+		std::atomic<bool> done{ false };
+		std::atomic<int> badReads{ 0 };
+
+		std::vector<std::thread> threads;
+		for(int thread = 0; thread < readers; ++thread){
+			threads.emplace_back([&](){
+				while(!done.load(std::memory_order_relaxed)){
+					CountedPtr loaded = atomic.load();
+					if(!loaded || loaded->twice != loaded->value * 2){
+						++badReads;
+					}
+					CountedPtr other = scratch.load();
+					if(other && other->twice != other->value * 2){
+						++badReads;
+					}
+				}
+			});
+		}
+
+		//Every increment is a compareExchange loop, so the final value shows whether any were lost
+		std::vector<std::thread> writerThreads;
+		for(int thread = 0; thread < writers; ++thread){
+			writerThreads.emplace_back([&, thread](){
+				for(int i = 0; i < increments; ++i){
+					CountedPtr expected = atomic.load();
+					while(!atomic.compareExchange(expected, agm::makeShared<Counted, agm::AtomicCounter>(expected->value + 1))){
+					}
+					scratch.store(agm::makeShared<Counted, agm::AtomicCounter>(thread));
+					CountedPtr taken = scratch.exchange(CountedPtr());
+				}
+			});
+		}
+		for(std::thread& thread : writerThreads){
+			thread.join();
+		}
+		done = true;
+		for(std::thread& thread : threads){
+			thread.join();
+		}
+
+		CHECK(badReads == 0);
+		CHECK(atomic.load()->value == writers * increments);
+		//Only the held objects are left, so no snapshot kept a reference it should have given back
+		CHECK(liveCount == (scratch.load() ? 2 : 1));
+	}
+	CHECK(liveCount == 0);
+}
+
+int main(){
+	//AtomicSharedPtr only accepts AtomicCounter
+	testLoadStore();
+	testExchange();
+	testCompareExchange();
+	testThreads();
+
+	return test::result();
+}
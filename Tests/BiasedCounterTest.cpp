@@ -0,0 +1,160 @@
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/////////TYPES
+static std::atomic<int> liveCount{ 0 };
+
+struct Counted{
+	int value;
+
+	explicit Counted(int inValue) : value(inValue){ ++liveCount; }
+	~Counted(){ --liveCount; }
+};
+
+typedef agm::SharedPtr<Counted, agm::DefaultDeleter, agm::BiasedCounter> BiasedPtr;
+typedef agm::WeakPtr<Counted, agm::DefaultDeleter, agm::BiasedCounter> BiasedWeakPtr;
+
+//Holds a reference made on the owning thread, so destroying it releases that thread's count of the child
+struct Holder{
+	BiasedPtr child;
+
+	explicit Holder(const BiasedPtr& inChild) : child(inChild){ ++liveCount; }
+	~Holder(){ --liveCount; }
+};
+
+typedef agm::SharedPtr<Holder, agm::DefaultDeleter, agm::BiasedCounter> HolderPtr;
+
+//Releases the pointers on another thread and waits for it
+template<typename... PtrTypes>
+static void releaseElsewhere(PtrTypes&&... ptrs){
+	std::thread([](std::decay_t<PtrTypes>... moved){
+		//Destroyed in order, so the first pointer is queued first
+		(moved.reset(), ...);
+	}, std::move(ptrs)...).join();
+}
+
+/////////TESTS
+//A reference given away while the owner still holds one is merged by the owner's next release
+static void testQueuedWhileHeld(){
+	BiasedPtr owned = agm::makeShared<Counted, agm::BiasedCounter>(1);
+	BiasedPtr given = owned;
+
+	releaseElsewhere(std::move(given));
+	CHECK(liveCount == 1);
+	CHECK(owned->value == 1);
+
+	owned.reset();
+	CHECK(liveCount == 0);
+}
+
+//Once the owner has given everything away the object waits on its queue until it merges
+static void testMergeBiasedCounts(){
+	std::vector<BiasedPtr> objects;
+	for(int i = 0; i < 8; ++i){
+		objects.push_back(agm::makeShared<Counted, agm::BiasedCounter>(i));
+	}
+	BiasedWeakPtr weak = objects.front();
+
+	//Several threads at once, so they all go through the queue together
+	std::vector<std::thread> threads;
+	for(int thread = 0; thread < 4; ++thread){
+		threads.emplace_back([](BiasedPtr first, BiasedPtr second){
+			first.reset();
+			second.reset();
+		}, std::move(objects[thread * 2]), std::move(objects[thread * 2 + 1]));
+	}
+	for(std::thread& thread : threads){
+		thread.join();
+	}
+	CHECK(liveCount == 8);
+
+	agm::mergeBiasedCounts();
+	CHECK(liveCount == 0);
+	CHECK(!weak.pin());
+
+	//Nothing queued is a no-op
+	agm::mergeBiasedCounts();
+	CHECK(liveCount == 0);
+}
+
+//A queued object hasn't started being destroyed, so it can still be pinned, and releasing the pin merges it
+static void testPinQueued(){
+	BiasedPtr owned = agm::makeShared<Counted, agm::BiasedCounter>(2);
+	BiasedWeakPtr weak = owned;
+
+	releaseElsewhere(std::move(owned));
+	CHECK(liveCount == 1);
+
+	BiasedPtr pinned = weak.pin();
+	CHECK(pinned && pinned->value == 2);
+	pinned.reset();
+	CHECK(liveCount == 0);
+	CHECK(!weak.pin());
+}
+
+//Destroying one queued object releases the owner's last reference to another that is queued behind it
+static void testQueuedReleasesQueued(){
+	BiasedPtr child = agm::makeShared<Counted, agm::BiasedCounter>(3);
+	HolderPtr holder = agm::makeShared<Holder, agm::BiasedCounter>(child);
+	CHECK(liveCount == 2);
+
+	releaseElsewhere(std::move(child), std::move(holder));
+	CHECK(liveCount == 2);
+
+	agm::mergeBiasedCounts();
+	CHECK(liveCount == 0);
+}
+
+//Releasing an object whose owner has exited merges it straight away
+static void testOwnerExited(){
+	BiasedPtr orphan;
+	std::thread([&orphan](){
+		orphan = agm::makeShared<Counted, agm::BiasedCounter>(4);
+	}).join();
+	CHECK(liveCount == 1);
+
+	BiasedPtr copy = orphan;
+	orphan.reset();
+	CHECK(liveCount == 1);
+	copy.reset();
+	CHECK(liveCount == 0);
+}
+
+//An object queued on a thread is merged when that thread exits
+static void testMergeOnExit(){
+	BiasedPtr given;
+	std::promise<void> made;
+	std::promise<void> released;
+
+	std::thread owner([&](){
+		given = agm::makeShared<Counted, agm::BiasedCounter>(5);
+		made.set_value();
+		released.get_future().wait();
+	});
+
+	made.get_future().wait();
+	given.reset();
+	CHECK(liveCount == 1);
+
+	released.set_value();
+	owner.join();
+	CHECK(liveCount == 0);
+}
+
+int main(){
+	testQueuedWhileHeld();
+	testMergeBiasedCounts();
+	testPinQueued();
+	testQueuedReleasesQueued();
+	testOwnerExited();
+	testMergeOnExit();
+
+	return test::result();
+}
@@ -0,0 +1,145 @@
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <utility>
+
+/////////TYPES
+static int liveCount = 0;
+
+struct Base{
+	int value = 1;
+
+	Base(){ ++liveCount; }
+	virtual ~Base(){ --liveCount; }
+};
+
+struct Derived : Base{
+	int extra = 2;
+
+	Derived(){ ++liveCount; }
+	~Derived() override{ --liveCount; }
+};
+
+struct Other : Base{
+};
+
+struct Pod{
+	int first;
+	int second;
+};
+
+//Counts how often it is called, to see that the cast result keeps the deleter
+struct CountingDeleter{
+	int* calls = nullptr;
+
+	template<typename Type>
+	void operator ()(Type* ptr){
+		++*calls;
+		delete ptr;
+	}
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testSharedCasts(){
+	typedef agm::SharedPtr<Base, agm::DefaultDeleter, CounterType> BasePtr;
+	typedef agm::SharedPtr<Derived, agm::DefaultDeleter, CounterType> DerivedPtr;
+
+	{
+		BasePtr base = agm::makeShared<Derived, CounterType>();
+
+		DerivedPtr copied = agm::staticCast<Derived>(base);
+		CHECK(copied.get() == base.get());
+		CHECK(copied->extra == 2);
+
+		DerivedPtr dynamic = agm::dynamicCast<Derived>(base);
+		CHECK(dynamic.get() == base.get());
+		CHECK(!agm::dynamicCast<Other>(base));
+
+		agm::SharedPtr<const Base, agm::DefaultDeleter, CounterType> constant = base;
+		BasePtr mutableAgain = agm::constCast<Base>(constant);
+		CHECK(mutableAgain.get() == base.get());
+
+		//A failed rvalue dynamicCast leaves the source as it was
+		BasePtr source = base;
+		CHECK(!agm::dynamicCast<Other>(std::move(source)));
+		CHECK(source.get() == base.get());
+
+		DerivedPtr moved = agm::staticCast<Derived>(std::move(source));
+		CHECK(!source);
+		CHECK(moved.get() == base.get());
+	}
+	CHECK(liveCount == 0);
+
+	{
+		agm::SharedPtr<Pod, agm::DefaultDeleter, CounterType> pod = agm::makeShared<Pod, CounterType>(Pod{ 3, 4 });
+		agm::SharedPtr<int, agm::DefaultDeleter, CounterType> first = agm::reinterpretCast<int>(pod);
+		CHECK(*first == 3);
+	}
+}
+
+template<typename CounterType>
+static void testWeakCasts(){
+	typedef agm::WeakPtr<Base, agm::DefaultDeleter, CounterType> WeakBase;
+	typedef agm::WeakPtr<Derived, agm::DefaultDeleter, CounterType> WeakDerived;
+
+	agm::SharedPtr<Base, agm::DefaultDeleter, CounterType> base = agm::makeShared<Derived, CounterType>();
+	WeakBase weak = base;
+
+	WeakDerived derived = agm::dynamicCast<Derived>(weak);
+	CHECK(agm::SharedPtr<Derived, agm::DefaultDeleter, CounterType>(derived).get() == base.get());
+	CHECK(!agm::SharedPtr<Other, agm::DefaultDeleter, CounterType>(agm::dynamicCast<Other>(weak)));
+
+	WeakDerived statically = agm::staticCast<Derived>(std::move(weak));
+	base.reset();
+	CHECK(liveCount == 0);
+	CHECK(!agm::SharedPtr<Derived, agm::DefaultDeleter, CounterType>(statically));
+
+	//An expired WeakPtr can't be looked at, so dynamicCast gives an empty one
+	CHECK(!agm::SharedPtr<Derived, agm::DefaultDeleter, CounterType>(agm::dynamicCast<Derived>(WeakBase(derived))));
+}
+
+static void testUniqueCasts(){
+	int calls = 0;
+	{
+		agm::UniquePtr<Base, CountingDeleter> base(new Derived(), CountingDeleter{ &calls });
+
+		agm::UniquePtr<Derived, CountingDeleter> derived = agm::staticCast<Derived>(base.move());
+		CHECK(!base);
+		CHECK(derived->extra == 2);
+		CHECK(derived.getDeleter().calls == &calls);
+
+		agm::UniquePtr<Base, CountingDeleter> back = std::move(derived);
+		agm::UniquePtr<Other, CountingDeleter> failed = agm::dynamicCast<Other>(std::move(back));
+		CHECK(!failed);
+		CHECK(back);
+
+		agm::UniquePtr<const Base, CountingDeleter> constant = std::move(back);
+		agm::UniquePtr<Base, CountingDeleter> mutableAgain = agm::constCast<Base>(constant.move());
+		CHECK(mutableAgain->value == 1);
+		CHECK(liveCount == 2);
+	}
+	CHECK(calls == 1);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testSharedCasts<CounterType>();
+	if constexpr(!agm::IsStrongOnly<CounterType>::value){
+		testWeakCasts<CounterType>();
+	}
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	testUniqueCasts();
+
+	return test::result();
+}
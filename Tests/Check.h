@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+
+/////////CHECK
+//Minimal test support so the tests don't need a framework. Unlike assert the checks still run in release builds,
+//and a failing check is reported and counted instead of stopping the test
+namespace test{
+	inline int& failureCount(){
+		static int count = 0;
+		return count;
+	}
+
+	inline void check(bool passed, const char* expression, const char* file, int line){
+		if(!passed){
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+			++failureCount();
+		}
+	}
+
+	//Return this from main
+	inline int result(){
+		if(failureCount() > 0){
+			std::fprintf(stderr, "%d check(s) failed\n", failureCount());
+			return 1;
+		}
+		return 0;
+	}
+}
+
+//Variadic so template argument lists with commas can be checked without extra brackets
+#define CHECK(...) test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
@@ -0,0 +1,114 @@
+//Built with checked access whatever the rest of the build uses, as that is what this tests
+#ifndef AGM_CHECKED_ACCESS
+#define AGM_CHECKED_ACCESS
+#endif
+
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/////////TYPES
+struct Value{
+	int value = 1;
+};
+
+//Runs function in a child process and reports whether it stopped with SIGABRT after printing message
+template<typename Function>
+static bool aborts(Function function, const char* message){
+	int output[2];
+	if(pipe(output) != 0){
+		return false;
+	}
+
+	std::fflush(nullptr);
+	const pid_t child = fork();
+	if(child == 0){
+		close(output[0]);
+		dup2(output[1], STDERR_FILENO);
+		function();
+		_exit(0);
+	}
+	close(output[1]);
+
+	std::string printed;
+	char buffer[256];
+	ssize_t read;
+	while((read = ::read(output[0], buffer, sizeof(buffer))) > 0){
+		printed.append(buffer, static_cast<std::size_t>(read));
+	}
+	close(output[0]);
+
+	int status = 0;
+	waitpid(child, &status, 0);
+	return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT && printed.find(message) != std::string::npos;
+}
+
+//Keeps the reads from being optimised out
+static volatile int sink = 0;
+
+/////////TESTS
+static void testNull(){
+	CHECK(aborts([](){
+		agm::SharedPtr<Value> shared;
+		sink = shared->value;
+	}, "agm: dereferenced a null pointer"));
+
+	CHECK(aborts([](){
+		agm::UniquePtr<Value> unique;
+		sink = (*unique).value;
+	}, "agm: dereferenced a null pointer"));
+
+	CHECK(aborts([](){
+		agm::UniquePtr<Value> unique = agm::makeUnique(new Value());
+		agm::UniquePtr<Value> taken = std::move(unique);
+		sink = unique->value;
+	}, "agm: dereferenced a null pointer"));
+}
+
+static void testExpired(){
+	CHECK(aborts([](){
+		agm::SharedPtr<Value> shared = agm::makeShared<Value>();
+		agm::WeakPtr<Value> weak = shared;
+		shared.reset();
+		sink = weak->value;
+	}, "agm: dereferenced an expired pointer"));
+}
+
+static void testOutOfRange(){
+	CHECK(aborts([](){
+		agm::SharedPtr<int[]> shared = agm::makeSharedArray<int>(3);
+		sink = shared[3];
+	}, "agm: dereferenced an out of range pointer"));
+
+	CHECK(aborts([](){
+		agm::UniquePtr<int[]> unique = agm::makeUniqueArray<int>(3);
+		sink = unique[100];
+	}, "agm: dereferenced an out of range pointer"));
+}
+
+//Valid accesses run to the end, so the checks above are what stop the children
+static void testValid(){
+	CHECK(!aborts([](){
+		agm::SharedPtr<Value> shared = agm::makeShared<Value>();
+		agm::WeakPtr<Value> weak = shared;
+		agm::SharedPtr<int[]> array = agm::makeSharedArray<int>(3);
+		sink = shared->value + weak->value + array[2];
+	}, ""));
+}
+
+int main(){
+	testNull();
+	testExpired();
+	testOutOfRange();
+	testValid();
+
+	return test::result();
+}
@@ -0,0 +1,171 @@
+#include "CowPtr.h"
+
+#include "Check.h"
+
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/////////TYPES
+static int copyCount = 0;
+static bool failCopy = false;
+
+struct Document{
+	std::vector<int> lines;
+
+	explicit Document(std::vector<int> inLines) : lines(std::move(inLines)){}
+	Document(const Document& other) : lines(other.lines){
+		if(failCopy){
+			throw std::runtime_error("copy");
+		}
+		++copyCount;
+	}
+};
+
+struct Settings{
+	int level;
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testCopyBeforeWrite(){
+	copyCount = 0;
+
+	agm::CowPtr<Document, CounterType> current = agm::makeCow<Document, CounterType>(std::vector<int>{ 1, 2, 3 });
+	CHECK(current.isUnique());
+
+	//Writing while alone changes the object in place
+	current.write().lines.push_back(4);
+	CHECK(copyCount == 0);
+
+	agm::CowPtr<Document, CounterType> snapshot = current;
+	CHECK(!current.isUnique());
+	CHECK(!snapshot.isUnique());
+	CHECK(snapshot.get() == current.get());
+	CHECK(copyCount == 0);
+
+	//The first write after a copy clones, and the snapshot keeps what it saw
+	const Document* before = current.get();
+	current.write().lines.push_back(5);
+	CHECK(copyCount == 1);
+	CHECK(current.get() != before);
+	CHECK(snapshot.get() == before);
+	CHECK(snapshot->lines.size() == 4);
+	CHECK(current->lines.size() == 5);
+	CHECK(current.isUnique());
+	CHECK(snapshot.isUnique());
+
+	//Later writes are in place again
+	current.write().lines.push_back(6);
+	snapshot.write().lines.clear();
+	CHECK(copyCount == 1);
+	CHECK((*current).lines.size() == 6);
+	CHECK(snapshot->lines.empty());
+}
+
+template<typename CounterType>
+static void testThrowingCopy(){
+	agm::CowPtr<Document, CounterType> current = agm::makeCow<Document, CounterType>(std::vector<int>{ 1 });
+	agm::CowPtr<Document, CounterType> snapshot = current;
+
+	failCopy = true;
+	bool threw = false;
+	try{
+		current.write();
+	} catch(const std::runtime_error&){
+		threw = true;
+	}
+	failCopy = false;
+
+	//Still sharing the old object
+	CHECK(threw);
+	CHECK(current.get() == snapshot.get());
+	CHECK(!current.isUnique());
+}
+
+template<typename CounterType>
+static void testResetAndSwap(){
+	agm::CowPtr<Document, CounterType> first = agm::makeCow<Document, CounterType>(std::vector<int>{ 1 });
+	agm::CowPtr<Document, CounterType> second = agm::makeCow<Document, CounterType>(std::vector<int>{ 2, 2 });
+	agm::CowPtr<Document, CounterType> copy = first;
+
+	swap(first, second);
+	CHECK(first->lines.size() == 2);
+	CHECK(second.get() == copy.get());
+
+	copy.reset();
+	CHECK(!copy);
+	CHECK(!copy.isUnique());
+	CHECK(second.isUnique());
+
+	agm::CowPtr<Document, CounterType> empty;
+	CHECK(!empty);
+	CHECK(empty.get() == nullptr);
+}
+
+//Snapshots handed to other threads clone on their first write there, and the original is never changed
+template<typename CounterType>
+static void testThreads(){
+	agm::CowPtr<Document, CounterType> current = agm::makeCow<Document, CounterType>(std::vector<int>{ 1, 2, 3 });
+	const Document* original = current.get();
+
+	std::vector<std::thread> threads;
+	std::vector<int> sizes(4, 0);
+	for(int thread = 0; thread < 4; ++thread){
+		threads.emplace_back([snapshot = current, &sizes, thread]() mutable{
+			for(int i = 0; i <= thread; ++i){
+				snapshot.write().lines.push_back(thread);
+			}
+			sizes[thread] = static_cast<int>(snapshot->lines.size());
+		});
+	}
+	for(std::thread& thread : threads){
+		thread.join();
+	}
+
+	for(int thread = 0; thread < 4; ++thread){
+		CHECK(sizes[thread] == 4 + thread);
+	}
+	CHECK(current.get() == original);
+	CHECK(current->lines.size() == 3);
+	CHECK(current.isUnique());
+}
+
+//Writing through an empty CowPtr gives it a value initialised object of its own
+template<typename CounterType>
+static void testWriteEmpty(){
+	agm::CowPtr<Settings, CounterType> settings;
+	agm::CowPtr<Settings, CounterType> emptyCopy = settings;
+
+	CHECK(settings.write().level == 0);
+	settings.write().level = 3;
+	CHECK(settings);
+	CHECK(settings.isUnique());
+	CHECK(settings->level == 3);
+	CHECK(!emptyCopy);
+
+	settings.reset();
+	CHECK(settings.write().level == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testCopyBeforeWrite<CounterType>();
+	testThrowingCopy<CounterType>();
+	testResetAndSwap<CounterType>();
+	testWriteEmpty<CounterType>();
+}
+
+int main(){
+	//BiasedCounter can't tell whether the CowPtr is alone until its counts are merged
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	testThreads<agm::AtomicCounter>();
+	testThreads<agm::AtomicStrongCounter>();
+
+	return test::result();
+}
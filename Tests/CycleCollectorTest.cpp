@@ -0,0 +1,156 @@
+#include "CycleCollector.h"
+
+#include "Check.h"
+
+#include <vector>
+
+/////////TYPES
+static int liveCount = 0;
+
+template<typename CounterType>
+struct Node : agm::Collectable<Node<CounterType>, CounterType>{
+	typedef agm::SharedPtr<Node<CounterType>, agm::DefaultDeleter, CounterType> NodePtr;
+	typedef typename agm::Collectable<Node<CounterType>, CounterType>::Tracer Tracer;
+
+	std::vector<NodePtr> children;
+	NodePtr parent;
+
+	Node(){ ++liveCount; }
+	~Node() override{ --liveCount; }
+
+	void traceEdges(Tracer& tracer) override{
+		for(NodePtr& child : children){
+			tracer(child);
+		}
+		tracer(parent);
+	}
+};
+
+//Reports more than its size, to see that reclaimedBytes uses getCollectableSize()
+template<typename CounterType>
+struct Heavy : Node<CounterType>{
+	std::size_t getCollectableSize() const override{
+		return 1000;
+	}
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testCycle(){
+	typedef typename Node<CounterType>::NodePtr NodePtr;
+
+	{
+		NodePtr root = agm::makeShared<Node<CounterType>, CounterType>();
+		root->children.push_back(agm::makeShared<Node<CounterType>, CounterType>());
+		root->children.back()->parent = root;
+	}
+	CHECK(liveCount == 2);
+
+	const agm::CycleStats stats = agm::collectCycles<CounterType>();
+	CHECK(stats.reclaimedObjects == 2);
+	CHECK(stats.reclaimedBytes == 2 * sizeof(Node<CounterType>));
+	CHECK(stats.remainingCandidates == 0);
+	CHECK(liveCount == 0);
+
+	//A node that points to itself
+	{
+		NodePtr self = agm::makeShared<Node<CounterType>, CounterType>();
+		self->parent = self;
+	}
+	CHECK(agm::collectCycles<CounterType>().reclaimedObjects == 1);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testReachableCycle(){
+	typedef typename Node<CounterType>::NodePtr NodePtr;
+
+	NodePtr outside;
+	{
+		NodePtr root = agm::makeShared<Node<CounterType>, CounterType>();
+		root->children.push_back(agm::makeShared<Node<CounterType>, CounterType>());
+		root->children.back()->parent = root;
+		outside = root->children.back();
+	}
+
+	//The cycle is still reachable through outside, so nothing is reclaimed and the graph is left as it was
+	agm::CycleStats stats = agm::collectCycles<CounterType>();
+	CHECK(stats.reclaimedObjects == 0);
+	CHECK(stats.scannedObjects >= 2);
+	CHECK(liveCount == 2);
+	CHECK(outside->parent);
+	CHECK(outside->parent->children.size() == 1);
+
+	outside.reset();
+	stats = agm::collectCycles<CounterType>();
+	CHECK(stats.reclaimedObjects == 2);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testAcyclic(){
+	typedef typename Node<CounterType>::NodePtr NodePtr;
+
+	//Releasing a shared node makes it a candidate, but a tree is freed by its counts alone
+	NodePtr root = agm::makeShared<Node<CounterType>, CounterType>();
+	NodePtr child = agm::makeShared<Node<CounterType>, CounterType>();
+	root->children.push_back(child);
+	child.reset();
+	CHECK(agm::collectCycles<CounterType>().reclaimedObjects == 0);
+	CHECK(liveCount == 2);
+
+	root.reset();
+	CHECK(liveCount == 0);
+	CHECK(agm::collectCycles<CounterType>().reclaimedObjects == 0);
+}
+
+template<typename CounterType>
+static void testBudget(){
+	typedef typename Node<CounterType>::NodePtr NodePtr;
+
+	//More candidates than one slice, with no time to do more than the first
+	for(int i = 0; i < 200; ++i){
+		NodePtr root = agm::makeShared<Node<CounterType>, CounterType>();
+		root->children.push_back(agm::makeShared<Node<CounterType>, CounterType>());
+		root->children.back()->parent = root;
+	}
+	CHECK(agm::CycleCollector<CounterType>::get().getCandidateCount() == 200);
+
+	agm::CycleStats stats = agm::collectCycles<CounterType>(std::chrono::nanoseconds(0));
+	CHECK(stats.reclaimedObjects > 0);
+	CHECK(stats.remainingCandidates > 0);
+	CHECK(liveCount == 400 - static_cast<int>(stats.reclaimedObjects));
+
+	stats = agm::collectCycles<CounterType>();
+	CHECK(stats.remainingCandidates == 0);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCollectableSize(){
+	typedef typename Node<CounterType>::NodePtr NodePtr;
+
+	{
+		NodePtr heavy = agm::makeShared<Heavy<CounterType>, CounterType>();
+		heavy->parent = heavy;
+	}
+	CHECK(agm::collectCycles<CounterType>().reclaimedBytes == 1000);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testCycle<CounterType>();
+	testReachableCycle<CounterType>();
+	testAcyclic<CounterType>();
+	testBudget<CounterType>();
+	testCollectableSize<CounterType>();
+}
+
+int main(){
+	//BiasedCounter has no exact count to trial delete from, and the strong only counters have no weak count
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+
+	return test::result();
+}
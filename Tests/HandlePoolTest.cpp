@@ -0,0 +1,147 @@
+#include "HandlePool.h"
+
+#include "Check.h"
+
+#include <stdexcept>
+
+/////////TYPES
+static int liveCount = 0;
+
+struct Unit{
+	int health;
+
+	explicit Unit(int inHealth) : health(inHealth){
+		if(inHealth < 0){
+			throw std::invalid_argument("health");
+		}
+		++liveCount;
+	}
+	~Unit(){ --liveCount; }
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testCreateAndDestroy(){
+	{
+		agm::HandlePool<Unit, CounterType> pool(2);
+		CHECK(pool.getCapacity() == 2);
+
+		agm::Handle<Unit> first = pool.create(10);
+		agm::Handle<Unit> second = pool.create(20);
+		CHECK(pool.size() == 2);
+		CHECK(pool.get(first)->health == 10);
+		CHECK(pool.get(second)->health == 20);
+		CHECK(first != second);
+
+		//Full
+		agm::Handle<Unit> third = pool.create(30);
+		CHECK(!pool.isValid(third));
+		CHECK(pool.get(third) == nullptr);
+
+		pool.destroy(first);
+		CHECK(!pool.isValid(first));
+		CHECK(pool.get(first) == nullptr);
+		CHECK(pool.size() == 1);
+		CHECK(liveCount == 1);
+
+		//The slot is reused, but the old handle stays invalid
+		agm::Handle<Unit> reused = pool.create(40);
+		CHECK(reused.getIndex() == first.getIndex());
+		CHECK(reused.getGeneration() != first.getGeneration());
+		CHECK(pool.get(first) == nullptr);
+		CHECK(pool.get(reused)->health == 40);
+
+		//Destroying a stale handle does nothing
+		pool.destroy(first);
+		CHECK(pool.isValid(reused));
+		CHECK(!pool.isValid(agm::Handle<Unit>()));
+	}
+	//The pool destroys whatever is left
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testThrowingConstructor(){
+	agm::HandlePool<Unit, CounterType> pool(1);
+	bool threw = false;
+	try{
+		pool.create(-1);
+	} catch(const std::invalid_argument&){
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(pool.size() == 0);
+
+	//The slot wasn't taken
+	CHECK(pool.isValid(pool.create(1)));
+}
+
+template<typename CounterType>
+static void testShare(){
+	agm::HandlePool<Unit, CounterType> pool(1);
+	agm::Handle<Unit> handle = pool.create(5);
+
+	agm::SharedPtr<Unit, agm::DefaultDeleter, CounterType> shared = pool.share(handle);
+	agm::SharedPtr<Unit, agm::DefaultDeleter, CounterType> again = pool.share(handle);
+	CHECK(shared.get() == pool.get(handle));
+	CHECK(again.get() == shared.get());
+
+	//The handle stops resolving, but the object lives on until the SharedPtrs are gone
+	pool.destroy(handle);
+	CHECK(!pool.isValid(handle));
+	CHECK(!pool.share(handle));
+	CHECK(liveCount == 1);
+	CHECK(shared->health == 5);
+
+	//Nothing free until then
+	CHECK(!pool.isValid(pool.create(6)));
+
+	if constexpr(!agm::IsStrongOnly<CounterType>::value){
+		agm::WeakPtr<Unit, agm::DefaultDeleter, CounterType> weak = shared;
+		shared.reset();
+		again.reset();
+		CHECK(liveCount == 0);
+		CHECK(!agm::SharedPtr<Unit, agm::DefaultDeleter, CounterType>(weak));
+	} else{
+		shared.reset();
+		again.reset();
+		CHECK(liveCount == 0);
+	}
+
+	agm::Handle<Unit> reused = pool.create(7);
+	CHECK(pool.isValid(reused));
+	CHECK(pool.get(handle) == nullptr);
+}
+
+template<typename CounterType>
+static void testSharedOutlivesHandle(){
+	agm::HandlePool<Unit, CounterType> pool(1);
+	agm::Handle<Unit> handle = pool.create(8);
+	{
+		agm::SharedPtr<Unit, agm::DefaultDeleter, CounterType> shared = pool.share(handle);
+	}
+	//Dropping every SharedPtr leaves the pool's own reference
+	CHECK(pool.isValid(handle));
+	CHECK(liveCount == 1);
+
+	pool.destroy(handle);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testCreateAndDestroy<CounterType>();
+	testThrowingConstructor<CounterType>();
+	testShare<CounterType>();
+	testSharedOutlivesHandle<CounterType>();
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	return test::result();
+}
@@ -0,0 +1,296 @@
+#include "InlinePtr.h"
+#include "Reclaim.h"
+
+#include "Check.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/////////TYPES
+static int liveCount = 0;
+
+struct Shape{
+	Shape(){ ++liveCount; }
+	Shape(const Shape&){ ++liveCount; }
+	virtual ~Shape(){ --liveCount; }
+
+	virtual int area() const = 0;
+};
+
+struct Square final : Shape{
+	int side;
+
+	explicit Square(int inSide) : side(inSide){
+		if(inSide < 0){
+			throw std::invalid_argument("side");
+		}
+	}
+	Square(Square&& other) noexcept : Shape(other), side(other.side){}
+
+	int area() const override{ return side * side; }
+};
+
+//Small enough, but not final, so a UniquePtr to one could really point to something bigger
+struct Rectangle : Shape{
+	int width;
+	int height;
+
+	Rectangle(int inWidth, int inHeight) : width(inWidth), height(inHeight){}
+	Rectangle(Rectangle&& other) noexcept : Shape(other), width(other.width), height(other.height){}
+
+	int area() const override{ return width * height; }
+};
+
+struct Polygon : Shape{
+	int points[64] = {};
+
+	int area() const override{ return 64; }
+};
+
+//Can't be moved without the chance of throwing, so it can't go in the buffer
+struct Fragile : Shape{
+	Fragile() = default;
+	Fragile(Fragile&&){}
+
+	int area() const override{ return 1; }
+};
+
+struct alignas(64) Aligned : Shape{
+	int area() const override{ return 2; }
+};
+
+typedef agm::InlinePtr<Shape> ShapePtr;
+
+//Small enough to go in the buffer, and owns the pointers it is replaced by through a heap object
+struct ChainLink{
+	ShapePtr next;
+	agm::UniquePtr<Square> spare;
+};
+
+struct Chain : Shape{
+	agm::UniquePtr<ChainLink> link;
+
+	Chain() : link(new ChainLink()){}
+	Chain(Chain&& other) noexcept : Shape(other), link(std::move(other.link)){}
+
+	int area() const override{ return 3; }
+};
+
+//Holds a whole ShapePtr, so it is too big for the buffer and always on the heap
+struct Node : Shape{
+	ShapePtr next;
+
+	int area() const override{ return 4; }
+};
+
+//Counts how often it is called, to see that heap objects go through the deleter
+struct CountingDeleter{
+	int* calls = nullptr;
+
+	template<typename Type>
+	void operator ()(Type* ptr){
+		++*calls;
+		delete ptr;
+	}
+};
+
+/////////TESTS
+static void testStorage(){
+	static_assert(ShapePtr::fitsInline<Square>);
+	static_assert(ShapePtr::fitsInline<Rectangle>);
+	static_assert(!ShapePtr::fitsInline<Polygon>);
+	static_assert(!ShapePtr::fitsInline<Fragile>);
+	static_assert(!ShapePtr::fitsInline<Aligned>);
+	static_assert(!agm::InlinePtr<Shape, 48, agm::DeferredDeleter>::fitsInline<Square>);
+
+	{
+		ShapePtr square = agm::makeInline<Shape, Square>(3);
+		CHECK(square.isInline());
+		CHECK(square->area() == 9);
+		CHECK(reinterpret_cast<const unsigned char*>(square.get()) >= reinterpret_cast<const unsigned char*>(&square));
+		CHECK(reinterpret_cast<const unsigned char*>(square.get()) < reinterpret_cast<const unsigned char*>(&square) + sizeof(square));
+
+		ShapePtr polygon = agm::makeInline<Shape, Polygon>();
+		CHECK(!polygon.isInline());
+		CHECK((*polygon).area() == 64);
+
+		ShapePtr fragile = agm::makeInline<Shape, Fragile>();
+		CHECK(!fragile.isInline());
+		ShapePtr aligned = agm::makeInline<Shape, Aligned>();
+		CHECK(!aligned.isInline());
+		CHECK(reinterpret_cast<std::uintptr_t>(aligned.get()) % 64 == 0);
+		CHECK(liveCount == 4);
+	}
+	CHECK(liveCount == 0);
+
+	ShapePtr empty;
+	CHECK(!empty);
+	CHECK(!empty.isInline());
+}
+
+static void testMoves(){
+	{
+		ShapePtr square = agm::makeInline<Shape, Square>(2);
+		ShapePtr polygon = agm::makeInline<Shape, Polygon>();
+		const Shape* heapObject = polygon.get();
+
+		//Inline objects move into the new buffer, heap objects are handed over
+		ShapePtr movedSquare = std::move(square);
+		CHECK(!square);
+		CHECK(movedSquare.isInline());
+		CHECK(movedSquare->area() == 4);
+
+		ShapePtr movedPolygon = polygon.move();
+		CHECK(!polygon);
+		CHECK(movedPolygon.get() == heapObject);
+		CHECK(liveCount == 2);
+
+		movedSquare = std::move(movedPolygon);
+		CHECK(liveCount == 1);
+		CHECK(!movedSquare.isInline());
+		CHECK(movedSquare.get() == heapObject);
+
+		//A vector of them keeps every object valid as it grows
+		std::vector<ShapePtr> shapes;
+		for(int i = 0; i < 50; ++i){
+			shapes.push_back(agm::makeInline<Shape, Square>(i));
+		}
+		bool allValid = true;
+		for(int i = 0; i < 50; ++i){
+			allValid = allValid && shapes[i].isInline() && shapes[i]->area() == i * i;
+		}
+		CHECK(allValid);
+		CHECK(liveCount == 51);
+	}
+	CHECK(liveCount == 0);
+}
+
+static void testEmplace(){
+	ShapePtr shape = agm::makeInline<Shape, Square>(1);
+
+	Rectangle& rectangle = shape.emplace<Rectangle>(2, 3);
+	CHECK(&rectangle == shape.get());
+	CHECK(shape.isInline());
+	CHECK(shape->area() == 6);
+	CHECK(liveCount == 1);
+
+	shape.emplace<Polygon>();
+	CHECK(!shape.isInline());
+	CHECK(liveCount == 1);
+
+	//A throwing constructor leaves it empty
+	bool threw = false;
+	try{
+		shape.emplace<Square>(-1);
+	} catch(const std::invalid_argument&){
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(!shape);
+	CHECK(liveCount == 0);
+
+	shape.emplace<Square>(5);
+	shape.reset();
+	CHECK(!shape);
+	CHECK(liveCount == 0);
+}
+
+static void testFromUnique(){
+	{
+		//Final and small enough, so the object is moved into the buffer
+		agm::UniquePtr<Square> square(new Square(4));
+		ShapePtr inlineSquare = std::move(square);
+		CHECK(!square);
+		CHECK(inlineSquare.isInline());
+		CHECK(inlineSquare->area() == 16);
+		CHECK(liveCount == 1);
+
+		//Not final, so the heap object is taken over as it is
+		Rectangle* created = new Rectangle(1, 2);
+		agm::UniquePtr<Rectangle> rectangle(created);
+		ShapePtr heapRectangle = std::move(rectangle);
+		CHECK(!rectangle);
+		CHECK(!heapRectangle.isInline());
+		CHECK(heapRectangle.get() == created);
+
+		heapRectangle = agm::UniquePtr<Square>(new Square(6));
+		CHECK(heapRectangle.isInline());
+		CHECK(heapRectangle->area() == 36);
+		CHECK(liveCount == 2);
+	}
+	CHECK(liveCount == 0);
+
+	int calls = 0;
+	{
+		agm::InlinePtr<Shape, 48, CountingDeleter> adopted(new Polygon(), CountingDeleter{ &calls });
+		CHECK(!adopted.isInline());
+		agm::InlinePtr<Shape, 48, CountingDeleter> moved = std::move(adopted);
+		CHECK(moved.getDeleter().calls == &calls);
+	}
+	CHECK(calls == 1);
+	CHECK(liveCount == 0);
+}
+
+static void testDeferred(){
+	typedef agm::InlinePtr<Shape, 48, agm::DeferredDeleter> DeferredShapePtr;
+
+	{
+		DeferredShapePtr adopted(new Square(2));
+		DeferredShapePtr converted = agm::UniquePtr<Square, agm::DeferredDeleter>(new Square(3));
+		CHECK(!adopted.isInline());
+		CHECK(!converted.isInline());
+		CHECK(converted->area() == 9);
+	}
+
+	//Destroyed by the next collect rather than when the pointers went away
+	CHECK(liveCount == 2);
+	CHECK(agm::collect() == 2);
+	CHECK(liveCount == 0);
+}
+
+//Assigning a pointer owned by the current object takes it over before the current object is destroyed
+static void testOwnNext(){
+	{
+		ShapePtr head = agm::makeInline<Shape, Chain>();
+		CHECK(head.isInline());
+		static_cast<Chain&>(*head).link->next = agm::makeInline<Shape, Square>(3);
+
+		head = std::move(static_cast<Chain&>(*head).link->next);
+		CHECK(head.isInline());
+		CHECK(head->area() == 9);
+		CHECK(liveCount == 1);
+	}
+	{
+		ShapePtr head = agm::makeInline<Shape, Node>();
+		CHECK(!head.isInline());
+		static_cast<Node&>(*head).next = agm::makeInline<Shape, Polygon>();
+
+		head = std::move(static_cast<Node&>(*head).next);
+		CHECK(head->area() == 64);
+		CHECK(liveCount == 1);
+	}
+	{
+		ShapePtr head = agm::makeInline<Shape, Chain>();
+		static_cast<Chain&>(*head).link->spare = agm::UniquePtr<Square>(new Square(5));
+
+		head = std::move(static_cast<Chain&>(*head).link->spare);
+		CHECK(head.isInline());
+		CHECK(head->area() == 25);
+		CHECK(liveCount == 1);
+	}
+	CHECK(liveCount == 0);
+}
+
+int main(){
+	//InlinePtr owns its object alone, so there is no counter policy to run it with
+	testStorage();
+	testMoves();
+	testEmplace();
+	testFromUnique();
+	testDeferred();
+	testOwnNext();
+
+	return test::result();
+}
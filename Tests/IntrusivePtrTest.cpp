@@ -0,0 +1,164 @@
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <cstdint>
+#include <utility>
+
+/////////TYPES
+static int liveCount = 0;
+
+template<typename CounterType>
+struct Shape : agm::RefCounted<Shape<CounterType>, CounterType>{
+	int sides;
+
+	explicit Shape(int inSides) : sides(inSides){ ++liveCount; }
+	virtual ~Shape(){ --liveCount; }
+};
+
+//More aligned than the base, so the object starts further into the allocation than a Shape would
+template<typename CounterType>
+struct Polygon final : Shape<CounterType>{
+	alignas(32) double area;
+
+	Polygon(int inSides, double inArea) : Shape<CounterType>(inSides), area(inArea){ ++liveCount; }
+	~Polygon() override{ --liveCount; }
+};
+
+//No virtual destructor, the block still destroys the type it created
+template<typename CounterType>
+struct Plain : agm::RefCounted<Plain<CounterType>, CounterType>{
+	Plain(){ ++liveCount; }
+	~Plain(){ --liveCount; }
+};
+
+template<typename CounterType>
+struct Tagged : Plain<CounterType>{
+	int tag;
+
+	explicit Tagged(int inTag) : tag(inTag){ ++liveCount; }
+	~Tagged(){ --liveCount; }
+};
+
+//Only owned by the link before it, so assigning next to the pointer that owns the link releases next as well
+template<typename CounterType>
+struct Link : agm::RefCounted<Link<CounterType>, CounterType>{
+	int value;
+	agm::IntrusivePtr<Link<CounterType>, CounterType> next;
+
+	explicit Link(int inValue) : value(inValue){ ++liveCount; }
+	~Link(){ --liveCount; }
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testLifetime(){
+	{
+		agm::IntrusivePtr<Shape<CounterType>, CounterType> shape = agm::makeIntrusive<Shape<CounterType>>(3);
+		CHECK(shape->sides == 3);
+		CHECK(liveCount == 1);
+
+		//From a raw pointer to an object made by makeIntrusive
+		agm::IntrusivePtr<Shape<CounterType>, CounterType> fromRaw(shape.get());
+		CHECK(fromRaw.get() == shape.get());
+
+		agm::IntrusivePtr<Shape<CounterType>, CounterType> fromThis = shape->getIntrusiveThis();
+		shape.reset();
+		fromRaw.reset();
+		CHECK(liveCount == 1);
+		CHECK(fromThis->sides == 3);
+	}
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testSharesCounts(){
+	agm::IntrusivePtr<Shape<CounterType>, CounterType> shape = agm::makeIntrusive<Shape<CounterType>>(4);
+	agm::SharedPtr<Shape<CounterType>, agm::DefaultDeleter, CounterType> shared = shape.getShared();
+	CHECK(shared.get() == shape.get());
+
+	if constexpr(!agm::IsStrongOnly<CounterType>::value){
+		agm::WeakPtr<Shape<CounterType>, agm::DefaultDeleter, CounterType> weak = shape.getWeak();
+		shape.reset();
+		CHECK(liveCount == 1);
+		shared.reset();
+		CHECK(liveCount == 0);
+		CHECK(!agm::SharedPtr<Shape<CounterType>, agm::DefaultDeleter, CounterType>(weak));
+	} else{
+		shape.reset();
+		CHECK(liveCount == 1);
+		shared.reset();
+		CHECK(liveCount == 0);
+	}
+}
+
+template<typename CounterType>
+static void testConvertsToBase(){
+	{
+		agm::IntrusivePtr<Polygon<CounterType>, CounterType> polygon = agm::makeIntrusive<Polygon<CounterType>>(5, 2.5);
+		CHECK(reinterpret_cast<std::uintptr_t>(&polygon->area) % 32 == 0);
+
+		agm::IntrusivePtr<Shape<CounterType>, CounterType> copied = polygon;
+		agm::IntrusivePtr<Shape<CounterType>, CounterType> moved = agm::IntrusivePtr<Polygon<CounterType>, CounterType>(polygon);
+		CHECK(copied.get() == polygon.get());
+		CHECK(moved.get() == polygon.get());
+
+		polygon.reset();
+		copied.reset();
+		CHECK(liveCount == 2);
+		CHECK(moved->sides == 5);
+
+		//The base pointer finds the same counts, so the last release still destroys the whole Polygon
+		agm::SharedPtr<Shape<CounterType>, agm::DefaultDeleter, CounterType> shared = moved->getSharedThis();
+		moved.reset();
+		CHECK(liveCount == 2);
+	}
+	CHECK(liveCount == 0);
+
+	{
+		agm::IntrusivePtr<Plain<CounterType>, CounterType> plain = agm::makeIntrusive<Tagged<CounterType>>(7);
+		CHECK(liveCount == 2);
+		agm::IntrusivePtr<Plain<CounterType>, CounterType> fromRaw(plain.get());
+		plain = agm::IntrusivePtr<Plain<CounterType>, CounterType>();
+		CHECK(liveCount == 2);
+	}
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testOwnNext(){
+	agm::IntrusivePtr<Link<CounterType>, CounterType> head = agm::makeIntrusive<Link<CounterType>>(1);
+	head->next = agm::makeIntrusive<Link<CounterType>>(2);
+	head->next->next = agm::makeIntrusive<Link<CounterType>>(3);
+	CHECK(liveCount == 3);
+
+	head = std::move(head->next);
+	CHECK(head->value == 2);
+	CHECK(liveCount == 2);
+
+	head = head->next;
+	CHECK(head->value == 3);
+	CHECK(liveCount == 1);
+
+	head = head->next;
+	CHECK(!head);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testLifetime<CounterType>();
+	testSharesCounts<CounterType>();
+	testConvertsToBase<CounterType>();
+	testOwnNext<CounterType>();
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	return test::result();
+}
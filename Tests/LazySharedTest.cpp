@@ -0,0 +1,163 @@
+#include "LazyShared.h"
+
+#include "Check.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/////////TYPES
+struct Table{
+	int value;
+
+	explicit Table(int inValue = 0) : value(inValue){}
+};
+
+/////////TESTS
+//Calls warmUp() until the object is ready or it is clearly never going to be
+template<typename Type, typename CounterType>
+static bool warmUntilReady(agm::LazyShared<Type, CounterType>& lazy){
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while(std::chrono::steady_clock::now() < deadline){
+		lazy.warmUp();
+		if(lazy.isReady()){
+			return true;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+template<typename CounterType>
+static void testGet(){
+	std::atomic<int> calls{ 0 };
+	agm::LazyShared<Table, CounterType> lazy([&calls](){
+		++calls;
+		return agm::makeShared<Table, CounterType>(7);
+	});
+	CHECK(!lazy.isReady());
+
+	//Every thread sees the one object
+	std::vector<const Table*> seen(8, nullptr);
+	std::vector<std::thread> threads;
+	for(int thread = 0; thread < 8; ++thread){
+		threads.emplace_back([&lazy, &seen, thread](){
+			seen[thread] = lazy.get().get();
+		});
+	}
+	for(std::thread& thread : threads){
+		thread.join();
+	}
+
+	CHECK(calls == 1);
+	CHECK(lazy.isReady());
+	CHECK(lazy.get()->value == 7);
+	bool allSame = true;
+	for(const Table* table : seen){
+		allSame = allSame && table == lazy.get().get();
+	}
+	CHECK(allSame);
+
+	//Default constructs the object
+	agm::LazyShared<Table, CounterType> defaulted;
+	CHECK(defaulted.get()->value == 0);
+}
+
+template<typename CounterType>
+static void testThrowingFactory(){
+	int calls = 0;
+	agm::LazyShared<Table, CounterType> lazy([&calls](){
+		if(++calls == 1){
+			throw std::runtime_error("factory");
+		}
+		return agm::makeShared<Table, CounterType>(calls);
+	});
+
+	bool threw = false;
+	try{
+		lazy.get();
+	} catch(const std::runtime_error&){
+		threw = true;
+	}
+	CHECK(threw);
+	CHECK(!lazy.isReady());
+
+	//Nothing was stored, so the next get() tries again
+	CHECK(lazy.get()->value == 2);
+	CHECK(calls == 2);
+}
+
+template<typename CounterType>
+static void testWarmUp(){
+	std::atomic<int> calls{ 0 };
+	agm::LazyShared<Table, CounterType> lazy([&calls](){
+		++calls;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		return agm::makeShared<Table, CounterType>(3);
+	});
+
+	//get() waits for the warm up instead of building a second object
+	lazy.warmUp();
+	lazy.warmUp();
+	CHECK(lazy.get()->value == 3);
+	CHECK(calls == 1);
+
+	lazy.warmUp();
+	CHECK(calls == 1);
+
+	//Destroying it while a warm up is running waits for it
+	{
+		agm::LazyShared<Table, CounterType> abandoned([](){
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			return agm::makeShared<Table, CounterType>(4);
+		});
+		abandoned.warmUp();
+	}
+}
+
+template<typename CounterType>
+static void testFailedWarmUp(){
+	std::atomic<int> calls{ 0 };
+	agm::LazyShared<Table, CounterType> lazy([&calls](){
+		if(++calls == 1){
+			throw std::runtime_error("factory");
+		}
+		return agm::makeShared<Table, CounterType>(5);
+	});
+
+	//The first warm up fails quietly, a later one can still build the object
+	CHECK(warmUntilReady(lazy));
+	CHECK(calls == 2);
+	CHECK(lazy.get()->value == 5);
+}
+
+template<typename CounterType>
+static void testWeak(){
+	agm::LazyShared<Table, CounterType> lazy([](){
+		return agm::makeShared<Table, CounterType>(6);
+	});
+
+	agm::WeakPtr<Table, agm::DefaultDeleter, CounterType> weak = lazy.getWeak();
+	CHECK(agm::SharedPtr<Table, agm::DefaultDeleter, CounterType>(weak).get() == lazy.get().get());
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testGet<CounterType>();
+	testThrowingFactory<CounterType>();
+	testWarmUp<CounterType>();
+	testFailedWarmUp<CounterType>();
+	if constexpr(!agm::IsStrongOnly<CounterType>::value){
+		testWeak<CounterType>();
+	}
+}
+
+int main(){
+	//The object is handed to other threads, so only the thread safe counters are accepted
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	return test::result();
+}
@@ -0,0 +1,100 @@
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <string>
+
+/////////TYPES
+static int liveCount = 0;
+
+struct Node{
+	Node* parent;
+	int value;
+
+	explicit Node(Node* inParent, int inValue = 0) : parent(inParent), value(inValue){ ++liveCount; }
+	Node(const Node& other) : parent(other.parent), value(other.value){ ++liveCount; }
+	~Node(){ --liveCount; }
+};
+
+struct Base{
+	virtual ~Base() = default;
+};
+
+struct Derived : Base{
+	std::string name;
+
+	explicit Derived(std::string inName) : name(std::move(inName)){ ++liveCount; }
+	~Derived() override{ --liveCount; }
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testConstructsFromArguments(){
+	Node root(nullptr, 1);
+	{
+		//A Node* argument goes to the constructor, it is never adopted
+		agm::SharedPtr<Node, agm::DefaultDeleter, CounterType> child = agm::makeShared<Node, CounterType>(&root, 2);
+		CHECK(child->parent == &root);
+		CHECK(child->value == 2);
+
+		agm::SharedPtr<Node, agm::DefaultDeleter, CounterType> onlyParent = agm::makeShared<Node, CounterType>(&root);
+		CHECK(onlyParent->parent == &root);
+		CHECK(onlyParent.get() != &root);
+		CHECK(liveCount == 3);
+	}
+	CHECK(liveCount == 1);
+}
+
+template<typename CounterType>
+static void testCopyConstructs(){
+	Node original(nullptr, 5);
+	{
+		agm::SharedPtr<Node, agm::DefaultDeleter, CounterType> copy = agm::makeShared<Node, CounterType>(original);
+		CHECK(copy.get() != &original);
+		CHECK(copy->value == 5);
+	}
+	CHECK(liveCount == 1);
+}
+
+template<typename CounterType>
+static void testAdopts(){
+	{
+		Node* object = new Node(nullptr, 3);
+		agm::SharedPtr<Node, agm::DefaultDeleter, CounterType> adopted = agm::adoptShared<Node, CounterType>(object);
+		CHECK(adopted.get() == object);
+
+		agm::SharedPtr<Node, agm::DefaultDeleter, CounterType> copy = adopted;
+		CHECK(copy.get() == object);
+	}
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testConvertsToBase(){
+	{
+		agm::SharedPtr<Base, agm::DefaultDeleter, CounterType> base = agm::makeShared<Derived, CounterType>("made");
+		agm::SharedPtr<Base, agm::DefaultDeleter, CounterType> adopted = agm::adoptShared<Base, CounterType>(new Derived("adopted"));
+		CHECK(static_cast<Derived*>(base.get())->name == "made");
+		CHECK(static_cast<Derived*>(adopted.get())->name == "adopted");
+		CHECK(liveCount == 2);
+	}
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testConstructsFromArguments<CounterType>();
+	testCopyConstructs<CounterType>();
+	testAdopts<CounterType>();
+	testConvertsToBase<CounterType>();
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	return test::result();
+}
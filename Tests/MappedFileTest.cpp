@@ -0,0 +1,143 @@
+#include "MappedFile.h"
+
+#include "Check.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/////////TYPES
+//Writes a file for the test to map and removes it again
+class TemporaryFile{
+	//VARIABLES
+public:
+	std::string path;
+
+	//FUNCTIONS
+public:
+	explicit TemporaryFile(std::size_t size){
+		char name[] = "agmMappedFileXXXXXX";
+		const int file = ::mkstemp(name);
+		if(file < 0){
+			std::perror("mkstemp");
+			std::abort();
+		}
+		path = name;
+
+		for(std::size_t i = 0; i < size; ++i){
+			const unsigned char byte = valueAt(i);
+			if(::write(file, &byte, 1) != 1){
+				std::abort();
+			}
+		}
+		::close(file);
+	}
+	~TemporaryFile(){
+		std::remove(path.c_str());
+	}
+
+	static unsigned char valueAt(std::size_t offset){
+		return static_cast<unsigned char>(offset * 7 + offset / 251);
+	}
+};
+
+struct Record{
+	unsigned char first;
+	unsigned char second;
+};
+
+/////////TESTS
+//Checks every byte of a mapping against what was written at the same offset
+static bool matchesFile(const std::byte* data, std::size_t offset, std::size_t length){
+	for(std::size_t i = 0; i < length; ++i){
+		if(static_cast<unsigned char>(data[i]) != TemporaryFile::valueAt(offset + i)){
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename CounterType>
+static void testMapWhole(const TemporaryFile& file, std::size_t fileSize){
+	agm::MappedPtr<CounterType> mapped = agm::mapShared<CounterType>(file.path.c_str());
+	CHECK(mapped);
+	CHECK(mapped.size() == fileSize);
+	CHECK(matchesFile(mapped.get(), 0, fileSize));
+
+	agm::MappedPtr<CounterType> sequential = agm::mapShared<CounterType>(file.path.c_str(), agm::MapHint::Sequential);
+	CHECK(sequential.size() == fileSize);
+	CHECK(matchesFile(sequential.get(), 0, fileSize));
+}
+
+template<typename CounterType>
+static void testMapRange(const TemporaryFile& file, std::size_t fileSize){
+	//Offsets don't have to be page aligned
+	const std::size_t offset = 4096 + 13;
+	agm::MappedPtr<CounterType> range = agm::mapShared<CounterType>(file.path.c_str(), offset, 100, agm::MapHint::Random);
+	CHECK(range.size() == 100);
+	CHECK(matchesFile(range.get(), offset, 100));
+
+	//The length is clamped to the end of the file
+	agm::MappedPtr<CounterType> tail = agm::mapShared<CounterType>(file.path.c_str(), fileSize - 10, 1000, agm::MapHint::WillNeed);
+	CHECK(tail.size() == 10);
+	CHECK(matchesFile(tail.get(), fileSize - 10, 10));
+
+	//An aliasing pointer to a record keeps the whole mapping alive
+	agm::SharedPtr<const Record, agm::UnmapDeleter, CounterType> record(range, reinterpret_cast<const Record*>(range.get() + 2));
+	range.reset();
+	CHECK(record->first == TemporaryFile::valueAt(offset + 2));
+	CHECK(record->second == TemporaryFile::valueAt(offset + 3));
+}
+
+template<typename CounterType>
+static void testFailures(const TemporaryFile& file, const TemporaryFile& emptyFile, std::size_t fileSize){
+	errno = 0;
+	CHECK(!agm::mapShared<CounterType>("agmMappedFileMissing"));
+	CHECK(errno == ENOENT);
+
+	errno = 0;
+	CHECK(!agm::mapShared<CounterType>(emptyFile.path.c_str()));
+	CHECK(errno == EINVAL);
+
+	errno = 0;
+	CHECK(!agm::mapShared<CounterType>(file.path.c_str(), fileSize, 1));
+	CHECK(errno == EINVAL);
+
+	errno = 0;
+	CHECK(!agm::mapShared<CounterType>(file.path.c_str(), 0, 0));
+	CHECK(errno == EINVAL);
+}
+
+static void testAdvise(const TemporaryFile& file){
+	agm::MappedPtr<> mapped = agm::mapShared(file.path.c_str());
+
+	//Unaligned ranges are widened to whole pages
+	CHECK(agm::adviseMapped(mapped.get() + 100, 5000, agm::MapHint::WillNeed));
+	CHECK(agm::adviseMapped(mapped.get(), mapped.size(), agm::MapHint::Normal));
+	CHECK(matchesFile(mapped.get(), 0, mapped.size()));
+}
+
+template<typename CounterType>
+static void testCounter(const TemporaryFile& file, const TemporaryFile& emptyFile, std::size_t fileSize){
+	testMapWhole<CounterType>(file, fileSize);
+	testMapRange<CounterType>(file, fileSize);
+	testFailures<CounterType>(file, emptyFile, fileSize);
+}
+
+int main(){
+	//A few pages, and not a whole number of them
+	const std::size_t fileSize = 3 * 4096 + 123;
+	const TemporaryFile file(fileSize);
+	const TemporaryFile emptyFile(0);
+
+	testCounter<agm::Counter>(file, emptyFile, fileSize);
+	testCounter<agm::AtomicCounter>(file, emptyFile, fileSize);
+	testCounter<agm::BiasedCounter>(file, emptyFile, fileSize);
+	testCounter<agm::StrongCounter>(file, emptyFile, fileSize);
+	testCounter<agm::AtomicStrongCounter>(file, emptyFile, fileSize);
+
+	testAdvise(file);
+
+	return test::result();
+}
@@ -0,0 +1,219 @@
+#include "PoolAllocator.h"
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+/////////ALLOCATION FAILURES
+//The pools allocate their slabs with new[], which fails on request here
+static bool failArrayNew = false;
+
+void* operator new[](std::size_t size){
+	void* memory = failArrayNew ? nullptr : std::malloc(size);
+	if(!memory){
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete[](void* ptr) noexcept{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept{
+	std::free(ptr);
+}
+
+/////////TYPES
+static std::atomic<int> liveCount{ 0 };
+static int allocations = 0;
+static int deallocations = 0;
+
+struct Object{
+	int value;
+
+	explicit Object(int inValue) : value(inValue){ ++liveCount; }
+	~Object(){ --liveCount; }
+};
+
+//A size no other test type has, so it gets a pool of its own
+struct alignas(32) Isolated{
+	unsigned char bytes[96];
+};
+
+//Counts the calls that reach the pools, to see which allocator each part is given back to
+template<typename Type>
+struct CountingAllocator : agm::PoolAllocator<Type>{
+	typedef Type value_type;
+
+	CountingAllocator() = default;
+	template<typename OtherType> CountingAllocator(const CountingAllocator<OtherType>&){}
+
+	Type* allocate(std::size_t count){
+		++allocations;
+		return agm::PoolAllocator<Type>::allocate(count);
+	}
+	void deallocate(Type* ptr, std::size_t count){
+		++deallocations;
+		agm::PoolAllocator<Type>::deallocate(ptr, count);
+	}
+};
+
+template<typename Type, typename OtherType>
+bool operator ==(const CountingAllocator<Type>&, const CountingAllocator<OtherType>&){
+	return true;
+}
+template<typename Type, typename OtherType>
+bool operator !=(const CountingAllocator<Type>&, const CountingAllocator<OtherType>&){
+	return false;
+}
+
+/////////TESTS
+static void testPool(){
+	agm::PoolAllocator<Isolated> allocator;
+
+	//More than one slab, every chunk distinct and aligned
+	std::vector<Isolated*> chunks;
+	std::set<Isolated*> distinct;
+	bool aligned = true;
+	for(int i = 0; i < 200; ++i){
+		Isolated* chunk = allocator.allocate(1);
+		chunks.push_back(chunk);
+		distinct.insert(chunk);
+		aligned = aligned && reinterpret_cast<std::uintptr_t>(chunk) % alignof(Isolated) == 0;
+	}
+	CHECK(distinct.size() == 200);
+	CHECK(aligned);
+
+	//Freed chunks are reused before the pool grows
+	Isolated* last = chunks.back();
+	allocator.deallocate(last, 1);
+	CHECK(allocator.allocate(1) == last);
+	for(Isolated* chunk : chunks){
+		allocator.deallocate(chunk, 1);
+	}
+
+	//More than one object goes to the global heap instead
+	Isolated* many = allocator.allocate(3);
+	CHECK(reinterpret_cast<std::uintptr_t>(many) % alignof(Isolated) == 0);
+	allocator.deallocate(many, 3);
+
+	CHECK(agm::PoolAllocator<int>() == agm::PoolAllocator<Isolated>());
+	CHECK(!(agm::PoolAllocator<int>() != agm::PoolAllocator<Isolated>()));
+}
+
+static void testFailedGrowth(){
+	struct Fresh{
+		unsigned char bytes[200];
+	};
+	agm::PoolAllocator<Fresh> allocator;
+
+	failArrayNew = true;
+	bool threw = false;
+	try{
+		allocator.allocate(1);
+	} catch(const std::bad_alloc&){
+		threw = true;
+	}
+	failArrayNew = false;
+	CHECK(threw);
+
+	//The pool isn't left locked
+	Fresh* chunk = allocator.allocate(1);
+	CHECK(chunk != nullptr);
+	allocator.deallocate(chunk, 1);
+}
+
+template<typename CounterType>
+static void testAllocateShared(){
+	allocations = 0;
+	deallocations = 0;
+
+	//The object and its control block are one allocation, given back once the last WeakPtr is gone
+	agm::SharedPtr<Object, agm::DefaultDeleter, CounterType> shared = agm::allocateShared<Object, CounterType>(CountingAllocator<Object>(), 5);
+	CHECK(shared->value == 5);
+	CHECK(allocations == 1);
+	CHECK(liveCount == 1);
+
+	if constexpr(!agm::IsStrongOnly<CounterType>::value){
+		agm::WeakPtr<Object, agm::DefaultDeleter, CounterType> weak = shared;
+		shared.reset();
+		CHECK(liveCount == 0);
+		CHECK(deallocations == 0);
+		weak.reset();
+	} else{
+		shared.reset();
+		CHECK(liveCount == 0);
+	}
+	CHECK(deallocations == 1);
+
+	//Adopted objects only allocate their control block from the allocator
+	agm::SharedPtr<Object, agm::DefaultDeleter, CounterType> adopted(new Object(6), agm::DefaultDeleter(), CountingAllocator<Object>());
+	CHECK(allocations == 2);
+	adopted.reset();
+	CHECK(deallocations == 2);
+	CHECK(liveCount == 0);
+}
+
+static void testAllocateUnique(){
+	allocations = 0;
+	deallocations = 0;
+
+	agm::UniquePtr<Object, agm::AllocatorDeleter<CountingAllocator<Object>>> unique = agm::allocateUnique<Object>(CountingAllocator<Object>(), 7);
+	CHECK(unique->value == 7);
+	CHECK(allocations == 1);
+
+	unique.reset();
+	CHECK(deallocations == 1);
+	CHECK(liveCount == 0);
+}
+
+//Objects made on one thread and released on another hand their chunks back to the same pool
+static void testThreads(){
+	std::vector<agm::SharedPtr<Object, agm::DefaultDeleter, agm::AtomicCounter>> objects;
+	for(int i = 0; i < 1000; ++i){
+		objects.push_back(agm::allocateShared<Object, agm::AtomicCounter>(agm::PoolAllocator<Object>(), i));
+	}
+
+	std::vector<std::thread> threads;
+	for(int thread = 0; thread < 4; ++thread){
+		threads.emplace_back([&objects, thread](){
+			for(std::size_t i = thread; i < objects.size(); i += 4){
+				objects[i].reset();
+				agm::SharedPtr<Object, agm::DefaultDeleter, agm::AtomicCounter> made = agm::allocateShared<Object, agm::AtomicCounter>(agm::PoolAllocator<Object>(), thread);
+			}
+		});
+	}
+	for(std::thread& thread : threads){
+		thread.join();
+	}
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testAllocateShared<CounterType>();
+}
+
+int main(){
+	testPool();
+	testFailedGrowth();
+
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	testAllocateUnique();
+	testThreads();
+
+	return test::result();
+}
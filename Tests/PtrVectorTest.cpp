@@ -0,0 +1,263 @@
+#include "PtrVector.h"
+
+#include "Check.h"
+
+#include <utility>
+#include <vector>
+
+/////////TYPES
+static int liveCount = 0;
+static int grabCount = 0;
+static int releaseCount = 0;
+
+//Counts every strong grab and release, so the tests can tell a relocation from a copy
+class CountingCounter : public agm::Counter{
+public:
+	inline void grab() noexcept{
+		++grabCount;
+		Counter::grab();
+	}
+	inline bool tryGrab() noexcept{
+		++grabCount;
+		return Counter::tryGrab();
+	}
+	inline int release() noexcept{
+		++releaseCount;
+		return Counter::release();
+	}
+};
+
+struct Counted{
+	int value;
+
+	explicit Counted(int inValue) : value(inValue){ ++liveCount; }
+	~Counted(){ --liveCount; }
+};
+
+typedef agm::SharedPtr<Counted, agm::DefaultDeleter, CountingCounter> CountedPtr;
+
+//Stores its own address, so it can only be moved through its constructors
+struct SelfAware{
+	SelfAware* self;
+	CountedPtr counted;
+
+	explicit SelfAware(int value) : self(this), counted(agm::makeShared<Counted, CountingCounter>(value)){}
+	SelfAware(SelfAware&& other) noexcept : self(this), counted(std::move(other.counted)){}
+	SelfAware& operator =(SelfAware&& other) noexcept{
+		counted = std::move(other.counted);
+		return *this;
+	}
+};
+
+static_assert(agm::IsTriviallyRelocatable<CountedPtr>::value, "The pointers should take the realloc / memmove path");
+static_assert(!agm::IsTriviallyRelocatable<SelfAware>::value, "SelfAware should take the element by element path");
+
+template<typename PtrType>
+static bool holdsValues(const agm::PtrVector<PtrType>& vector, const std::vector<int>& values){
+	if(vector.size() != values.size()){
+		return false;
+	}
+	for(std::size_t i = 0; i < values.size(); ++i){
+		if(vector[i]->value != values[i]){
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool holdsValues(const agm::PtrVector<SelfAware>& vector, const std::vector<int>& values){
+	if(vector.size() != values.size()){
+		return false;
+	}
+	for(std::size_t i = 0; i < values.size(); ++i){
+		if(vector[i].self != &vector[i] || vector[i].counted->value != values[i]){
+			return false;
+		}
+	}
+	return true;
+}
+
+/////////TESTS
+//Growing relocates the elements, so every pointer still holds the same object and no counts are touched
+static void testGrowth(){
+	{
+		agm::PtrVector<CountedPtr> vector;
+		CHECK(vector.isEmpty());
+		CHECK(vector.getCapacity() == 0);
+
+		std::vector<Counted*> objects;
+		std::vector<int> values;
+		for(int i = 0; i < 100; ++i){
+			vector.pushBack(agm::makeShared<Counted, CountingCounter>(i));
+			objects.push_back(vector[i].get());
+			values.push_back(i);
+		}
+		CHECK(vector.size() == 100);
+		CHECK(vector.getCapacity() == 128);
+		CHECK(grabCount == 100 && releaseCount == 0);
+
+		vector.reserve(1000);
+		CHECK(vector.getCapacity() == 1000);
+		vector.reserve(10);
+		CHECK(vector.getCapacity() == 1000);
+		CHECK(grabCount == 100 && releaseCount == 0);
+
+		bool sameObjects = true;
+		for(std::size_t i = 0; i < objects.size(); ++i){
+			sameObjects = sameObjects && vector[i].get() == objects[i];
+		}
+		CHECK(sameObjects);
+		CHECK(holdsValues(vector, values));
+		CHECK(liveCount == 100);
+	}
+	CHECK(liveCount == 0);
+	CHECK(grabCount == releaseCount);
+}
+
+//An argument that refers to an element is copied before the storage moves
+static void testEmplaceOwnElement(){
+	{
+		agm::PtrVector<CountedPtr> vector;
+		for(int i = 0; i < 8; ++i){
+			vector.emplaceBack(agm::makeShared<Counted, CountingCounter>(i));
+		}
+		CHECK(vector.size() == vector.getCapacity());
+
+		const int grabsBefore = grabCount;
+		vector.emplaceBack(vector[0]);
+		CHECK(vector.size() == 9);
+		CHECK(vector[8].get() == vector[0].get());
+		CHECK(grabCount == grabsBefore + 1);
+		CHECK(liveCount == 8);
+	}
+	CHECK(liveCount == 0);
+	CHECK(grabCount == releaseCount);
+}
+
+//Inserting and erasing shift the rest with memmove, only the inserted and erased elements are counted
+static void testInsertErase(){
+	{
+		agm::PtrVector<CountedPtr> vector;
+		for(int i = 0; i < 8; ++i){
+			vector.pushBack(agm::makeShared<Counted, CountingCounter>(i));
+		}
+		Counted* first = vector[0].get();
+
+		//At capacity, so this insert also has to grow
+		int grabsBefore = grabCount;
+		vector.insert(0, agm::makeShared<Counted, CountingCounter>(10));
+		vector.insert(4, agm::makeShared<Counted, CountingCounter>(11));
+		vector.insert(vector.size(), agm::makeShared<Counted, CountingCounter>(12));
+		CHECK(grabCount == grabsBefore + 3);
+		CHECK(holdsValues(vector, { 10, 0, 1, 2, 11, 3, 4, 5, 6, 7, 12 }));
+		CHECK(vector[1].get() == first);
+
+		//Copies of a shared element keep it alive through the erase
+		CountedPtr kept = vector[2];
+		int releasesBefore = releaseCount;
+		grabsBefore = grabCount;
+		vector.erase(1, 3);
+		CHECK(releaseCount == releasesBefore + 3);
+		CHECK(grabCount == grabsBefore);
+		CHECK(holdsValues(vector, { 10, 11, 3, 4, 5, 6, 7, 12 }));
+		CHECK(liveCount == 9);
+		CHECK(kept->value == 1);
+
+		vector.erase(vector.size() - 1);
+		vector.erase(0);
+		CHECK(holdsValues(vector, { 11, 3, 4, 5, 6, 7 }));
+		CHECK(liveCount == 7);
+
+		vector.popBack();
+		CHECK(holdsValues(vector, { 11, 3, 4, 5, 6 }));
+	}
+	CHECK(liveCount == 0);
+	CHECK(grabCount == releaseCount);
+}
+
+//Copies grab every element once, moves and swaps don't touch the counts
+static void testCopyMove(){
+	{
+		agm::PtrVector<CountedPtr> vector;
+		for(int i = 0; i < 5; ++i){
+			vector.pushBack(agm::makeShared<Counted, CountingCounter>(i));
+		}
+
+		int grabsBefore = grabCount;
+		agm::PtrVector<CountedPtr> copy(vector);
+		CHECK(grabCount == grabsBefore + 5);
+		CHECK(copy[3].get() == vector[3].get());
+
+		agm::PtrVector<CountedPtr> assigned;
+		assigned.pushBack(agm::makeShared<Counted, CountingCounter>(9));
+		assigned = copy;
+		CHECK(holdsValues(assigned, { 0, 1, 2, 3, 4 }));
+		CHECK(liveCount == 5);
+
+		grabsBefore = grabCount;
+		const int releasesBefore = releaseCount;
+		agm::PtrVector<CountedPtr> moved(std::move(copy));
+		CHECK(copy.isEmpty());
+		assigned = std::move(moved);
+		CHECK(moved.isEmpty());
+		vector.swap(assigned);
+		CHECK(grabCount == grabsBefore);
+		//Only the elements assigned held before the move are released
+		CHECK(releaseCount == releasesBefore + 5);
+		CHECK(holdsValues(vector, { 0, 1, 2, 3, 4 }));
+
+		//assigned now holds what vector did, which is the same objects
+		vector.clear();
+		CHECK(vector.isEmpty());
+		CHECK(liveCount == 5);
+	}
+	CHECK(liveCount == 0);
+	CHECK(grabCount == releaseCount);
+}
+
+//Types that aren't trivially relocatable are moved through their constructors instead of memmove
+static void testNotRelocatable(){
+	{
+		agm::PtrVector<SelfAware> vector;
+		std::vector<int> values;
+		for(int i = 0; i < 20; ++i){
+			vector.emplaceBack(i);
+			values.push_back(i);
+		}
+		CHECK(holdsValues(vector, values));
+
+		vector.insert(0, SelfAware(20));
+		vector.insert(10, SelfAware(21));
+		vector.insert(vector.size(), SelfAware(22));
+		values.insert(values.begin(), 20);
+		values.insert(values.begin() + 10, 21);
+		values.push_back(22);
+		CHECK(holdsValues(vector, values));
+
+		vector.erase(3, 4);
+		values.erase(values.begin() + 3, values.begin() + 7);
+		vector.erase(vector.size() - 1);
+		values.pop_back();
+		CHECK(holdsValues(vector, values));
+		CHECK(liveCount == static_cast<int>(values.size()));
+
+		vector.reserve(100);
+		CHECK(holdsValues(vector, values));
+
+		agm::PtrVector<SelfAware> moved(std::move(vector));
+		CHECK(holdsValues(moved, values));
+	}
+	CHECK(liveCount == 0);
+	CHECK(grabCount == releaseCount);
+}
+
+int main(){
+	//The relocation doesn't depend on the counter, so one that counts its calls is enough
+	testGrowth();
+	testEmplaceOwnElement();
+	testInsertErase();
+	testCopyMove();
+	testNotRelocatable();
+
+	return test::result();
+}
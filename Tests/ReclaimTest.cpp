@@ -0,0 +1,140 @@
+#include "Reclaim.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+/////////TYPES
+static std::atomic<int> liveCount{ 0 };
+
+struct Tracked{
+	Tracked(){ ++liveCount; }
+	~Tracked(){ --liveCount; }
+};
+
+//Releasing the child from the destructor defers it while collect() is running
+struct Parent{
+	agm::SharedPtr<Tracked, agm::DeferredDeleter> child;
+
+	Parent() : child(agm::makeSharedDeferred<Tracked>()){ ++liveCount; }
+	~Parent(){ --liveCount; }
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testShared(){
+	agm::SharedPtr<Tracked, agm::DeferredDeleter, CounterType> shared = agm::makeSharedDeferred<Tracked, CounterType>();
+	agm::SharedPtr<Tracked, agm::DeferredDeleter, CounterType> adopted(new Tracked());
+	agm::SharedPtr<Tracked[], agm::DeferredDeleter, CounterType> array(new Tracked[3], 3);
+	CHECK(liveCount == 5);
+
+	shared.reset();
+	adopted.reset();
+	array.reset();
+	CHECK(liveCount == 5);
+
+	CHECK(agm::collect() == 3);
+	CHECK(liveCount == 0);
+}
+
+template<typename CounterType>
+static void testWeak(){
+	agm::SharedPtr<Tracked, agm::DeferredDeleter, CounterType> shared = agm::makeSharedDeferred<Tracked, CounterType>();
+	agm::WeakPtr<Tracked, agm::DeferredDeleter, CounterType> weak = shared;
+
+	//Queued objects can't be pinned again, even though they haven't been destroyed yet
+	shared.reset();
+	CHECK(liveCount == 1);
+	CHECK(!agm::SharedPtr<Tracked, agm::DeferredDeleter, CounterType>(weak));
+
+	agm::collect();
+	CHECK(liveCount == 0);
+}
+
+static void testUnique(){
+	{
+		agm::UniquePtr<Tracked, agm::DeferredDeleter> single(new Tracked());
+		agm::UniquePtr<Tracked[], agm::DeferredDeleter> array(new Tracked[3], 3);
+		CHECK(liveCount == 4);
+	}
+	CHECK(liveCount == 4);
+
+	CHECK(agm::collect() == 2);
+	CHECK(liveCount == 0);
+}
+
+static void testNestedDefer(){
+	agm::UniquePtr<Parent, agm::DeferredDeleter> parent(new Parent());
+	parent.reset();
+	CHECK(liveCount == 2);
+
+	//The child is deferred by the parent's destructor and collected in the same call
+	CHECK(agm::collect() == 2);
+	CHECK(liveCount == 0);
+}
+
+static void testStats(){
+	const agm::ReclaimStats before = agm::getReclaimStats();
+	{
+		agm::UniquePtr<Tracked, agm::DeferredDeleter> first(new Tracked());
+		agm::UniquePtr<Tracked, agm::DeferredDeleter> second(new Tracked());
+	}
+	CHECK(agm::getReclaimStats().depth == 2);
+
+	agm::collect();
+	const agm::ReclaimStats after = agm::getReclaimStats();
+	CHECK(after.depth == 0);
+	CHECK(after.peakDepth >= 2);
+	CHECK(after.deferred - before.deferred == 2);
+	CHECK(after.reclaimed - before.reclaimed == 2);
+	CHECK(after.batches > before.batches);
+}
+
+static void testReclaimThread(){
+	{
+		agm::ReclaimThread collector(std::chrono::milliseconds(1));
+
+		std::vector<std::thread> threads;
+		for(int thread = 0; thread < 4; ++thread){
+			threads.emplace_back([](){
+				for(int i = 0; i < 1000; ++i){
+					agm::SharedPtr<Tracked, agm::DeferredDeleter, agm::AtomicCounter> shared = agm::makeSharedDeferred<Tracked, agm::AtomicCounter>();
+					agm::UniquePtr<Tracked[], agm::DeferredDeleter> array(new Tracked[2], 2);
+				}
+			});
+		}
+		for(std::thread& thread : threads){
+			thread.join();
+		}
+	}
+
+	//The thread collects one last time when it is destroyed
+	CHECK(liveCount == 0);
+	CHECK(agm::getReclaimStats().depth == 0);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testShared<CounterType>();
+	if constexpr(!agm::IsStrongOnly<CounterType>::value){
+		testWeak<CounterType>();
+	}
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	testUnique();
+	testNestedDefer();
+	testStats();
+	testReclaimThread();
+
+	return test::result();
+}
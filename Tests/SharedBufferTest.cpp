@@ -0,0 +1,132 @@
+#include "SharedBuffer.h"
+
+#include "Check.h"
+
+#include <cstring>
+#include <utility>
+
+/////////TESTS
+template<typename CounterType>
+static void testCreate(){
+	agm::SharedBuffer<CounterType> zeroed = agm::makeSharedBuffer<CounterType>(16);
+	CHECK(zeroed.size() == 16);
+	CHECK(!zeroed.isEmpty());
+	CHECK(zeroed.end() - zeroed.begin() == 16);
+	bool allZero = true;
+	for(std::byte byte : zeroed){
+		allZero = allZero && byte == std::byte(0);
+	}
+	CHECK(allZero);
+
+	agm::SharedBuffer<CounterType> uninitialised = agm::makeSharedBufferUninitialised<CounterType>(8);
+	CHECK(uninitialised.size() == 8);
+	uninitialised[7] = std::byte(7);
+	CHECK(uninitialised.data()[7] == std::byte(7));
+
+	const char text[] = "hello";
+	agm::SharedBuffer<CounterType> copied = agm::copySharedBuffer<CounterType>(text, 5);
+	CHECK(copied.size() == 5);
+	CHECK(std::memcmp(copied.data(), text, 5) == 0);
+
+	agm::SharedBuffer<CounterType> empty = agm::copySharedBuffer<CounterType>(nullptr, 0);
+	CHECK(empty.isEmpty());
+	CHECK(empty.view().isEmpty());
+
+	agm::SharedBuffer<CounterType> none;
+	CHECK(!none);
+	CHECK(!none.view());
+	copied.reset();
+	CHECK(!copied);
+}
+
+template<typename CounterType>
+static void testViews(){
+	agm::SharedBuffer<CounterType> buffer = agm::copySharedBuffer<CounterType>("0123456789", 10);
+
+	agm::BufferView<CounterType> whole = buffer.view();
+	CHECK(whole.data() == buffer.data());
+	CHECK(whole.size() == 10);
+
+	agm::BufferView<CounterType> middle = buffer.slice(2, 5);
+	CHECK(middle.data() == buffer.data() + 2);
+	CHECK(middle.size() == 5);
+	CHECK(middle[0] == std::byte('2'));
+	CHECK(middle.sharesBuffer(whole));
+
+	//Slices of slices are relative to the view, and the count is clamped to its end
+	agm::BufferView<CounterType> inner = middle.slice(3);
+	CHECK(inner.data() == buffer.data() + 5);
+	CHECK(inner.size() == 2);
+	CHECK(middle.slice(1, 100).size() == 4);
+
+	//Writes through the buffer show through every view
+	buffer[5] = std::byte('x');
+	CHECK(inner[0] == std::byte('x'));
+
+	agm::BufferView<CounterType> trimmed = whole;
+	trimmed.removePrefix(1);
+	trimmed.removeSuffix(2);
+	CHECK(trimmed.data() == buffer.data() + 1);
+	CHECK(trimmed.size() == 7);
+	CHECK(trimmed.end() == buffer.end() - 2);
+
+	agm::SharedBuffer<CounterType> other = agm::makeSharedBuffer<CounterType>(10);
+	CHECK(!whole.sharesBuffer(other.view()));
+	CHECK(!agm::BufferView<CounterType>().sharesBuffer(agm::BufferView<CounterType>()));
+
+	//Offsets past the end stop the program with AGM_CHECKED_ACCESS instead
+	if constexpr(!agm::checkedAccess){
+		CHECK(middle.slice(20).isEmpty());
+		CHECK(middle.slice(20).data() == middle.end());
+
+		agm::BufferView<CounterType> cleared = middle;
+		cleared.removePrefix(20);
+		CHECK(cleared.isEmpty());
+		CHECK(cleared.sharesBuffer(middle));
+	}
+}
+
+template<typename CounterType>
+static void testOwnership(){
+	agm::BufferView<CounterType> tail;
+	{
+		agm::SharedBuffer<CounterType> buffer = agm::copySharedBuffer<CounterType>("abcdef", 6);
+
+		//Moving the buffer into a view hands over its reference
+		agm::BufferView<CounterType> view = std::move(buffer);
+		CHECK(!buffer);
+		CHECK(view.size() == 6);
+
+		//So does slicing a view that is going away
+		tail = std::move(view).slice(4);
+		CHECK(!view);
+		CHECK(view.isEmpty());
+	}
+
+	//The view keeps the bytes alive after the buffer is gone
+	CHECK(tail.size() == 2);
+	CHECK(std::memcmp(tail.data(), "ef", 2) == 0);
+
+	agm::BufferView<CounterType> copy = tail;
+	tail.reset();
+	CHECK(!tail);
+	CHECK(tail.isEmpty());
+	CHECK(copy[1] == std::byte('f'));
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testCreate<CounterType>();
+	testViews<CounterType>();
+	testOwnership<CounterType>();
+}
+
+int main(){
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+	testCounter<agm::StrongCounter>();
+	testCounter<agm::AtomicStrongCounter>();
+
+	return test::result();
+}
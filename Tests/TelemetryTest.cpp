@@ -0,0 +1,136 @@
+//Built with telemetry whatever the rest of the build uses, as that is what this tests
+#ifndef AGM_TELEMETRY
+#define AGM_TELEMETRY
+#endif
+
+#include "Ptr.h"
+
+#include "Check.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/////////TYPES
+struct Widget{
+	int value = 0;
+};
+
+//Returns everything function writes to the file it is given
+template<typename Function>
+static std::string capture(Function function){
+	std::FILE* file = std::tmpfile();
+	if(!file){
+		return std::string();
+	}
+	function(file);
+
+	std::string output;
+	std::rewind(file);
+	char buffer[256];
+	std::size_t read;
+	while((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0){
+		output.append(buffer, read);
+	}
+	std::fclose(file);
+	return output;
+}
+
+static std::uint64_t opCount(const agm::TypeTelemetry& type, agm::TelemetryOp op){
+	return type.ops[static_cast<int>(op)].load();
+}
+
+/////////TESTS
+static void testCounts(){
+	const agm::TypeTelemetry& type = agm::Telemetry::forType<Widget>();
+	CHECK(std::strcmp(type.name, "Widget") == 0);
+	CHECK(type.live == 0 && type.peak == 0 && type.allocations == 0);
+
+	agm::SharedPtr<Widget> first = agm::makeShared<Widget>();
+	CHECK(type.live == 1 && type.peak == 1 && type.allocations == 1);
+	CHECK(opCount(type, agm::TelemetryOp::Grab) == 1);
+
+	agm::SharedPtr<Widget> copy = first;
+	agm::WeakPtr<Widget> weak = first;
+	CHECK(opCount(type, agm::TelemetryOp::Grab) == 2);
+	CHECK(opCount(type, agm::TelemetryOp::WeakGrab) == 1);
+
+	{
+		agm::SharedPtr<Widget> second = agm::makeShared<Widget>();
+		agm::SharedPtr<Widget> third(new Widget());
+		CHECK(type.live == 3 && type.peak == 3 && type.allocations == 3);
+	}
+	CHECK(type.live == 1 && type.peak == 3);
+	CHECK(opCount(type, agm::TelemetryOp::Release) == 2);
+
+	weak.reset();
+	copy.reset();
+	first.reset();
+	CHECK(type.live == 0 && type.peak == 3 && type.allocations == 3);
+	CHECK(opCount(type, agm::TelemetryOp::Grab) == 4);
+	CHECK(opCount(type, agm::TelemetryOp::Release) == 4);
+	CHECK(opCount(type, agm::TelemetryOp::WeakRelease) == 1);
+
+	//A UniquePtr has no control block, only its free is counted
+	agm::UniquePtr<Widget> unique = agm::makeUnique(new Widget());
+	unique.reset();
+	CHECK(opCount(type, agm::TelemetryOp::UniqueFree) == 1);
+	CHECK(type.allocations == 3);
+}
+
+//Only one in every rate operations is counted, report() scales them back up
+static void testSampling(){
+	const agm::TypeTelemetry& type = agm::Telemetry::forType<Widget>();
+	agm::SharedPtr<Widget> shared = agm::makeShared<Widget>();
+
+	agm::Telemetry::setSampleRate(4);
+	CHECK(agm::Telemetry::getSampleRate() == 4);
+	const std::uint64_t grabsBefore = opCount(type, agm::TelemetryOp::Grab);
+	{
+		std::vector<agm::SharedPtr<Widget>> copies(8, shared);
+		CHECK(opCount(type, agm::TelemetryOp::Grab) == grabsBefore + 2);
+	}
+	agm::Telemetry::setSampleRate(0);
+	CHECK(agm::Telemetry::getSampleRate() == 1);
+}
+
+static void testReport(){
+	const std::string output = capture([](std::FILE* file){
+		agm::Telemetry::report(file);
+	});
+	CHECK(output.find("agm telemetry, sample rate 1\n") == 0);
+	CHECK(output.find("\nWidget ") != std::string::npos);
+}
+
+static void testLeakReport(){
+	CHECK(capture([](std::FILE* file){
+		CHECK(agm::Telemetry::reportLeaks(file) == 0);
+	}).empty());
+
+	agm::SharedPtr<Widget> kept = agm::makeShared<Widget>();
+	agm::WeakPtr<Widget> weak = kept;
+	const std::string output = capture([](std::FILE* file){
+		CHECK(agm::Telemetry::reportLeaks(file) == 1);
+	});
+	CHECK(output.find("agm leak report: 1 control blocks still alive\n") == 0);
+	CHECK(output.find("Widget") != std::string::npos);
+	//The strong references hold one weak reference between them
+	CHECK(output.find("strong 1, weak 2\n") != std::string::npos);
+
+	kept.reset();
+	weak.reset();
+	CHECK(capture([](std::FILE* file){
+		CHECK(agm::Telemetry::reportLeaks(file) == 0);
+	}).empty());
+}
+
+int main(){
+	testCounts();
+	testSampling();
+	testReport();
+	testLeakReport();
+
+	return test::result();
+}
@@ -0,0 +1,211 @@
+#include "WeakCache.h"
+
+#include "Check.h"
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/////////TYPES
+static int liveCount = 0;
+
+struct Asset{
+	std::string path;
+
+	explicit Asset(std::string inPath) : path(std::move(inPath)){ ++liveCount; }
+	~Asset(){ --liveCount; }
+};
+
+struct Pair{
+	int first = 1;
+	int second = 2;
+};
+
+//Every key lands in the same place, so lookups have to probe past other entries
+struct CollidingHash{
+	std::size_t operator ()(int) const noexcept{
+		return 0;
+	}
+};
+
+/////////TESTS
+template<typename CounterType>
+static void testFindAndCreate(){
+	typedef agm::SharedPtr<Asset, agm::DefaultDeleter, CounterType> AssetPtr;
+
+	agm::WeakCache<std::string, Asset, agm::DefaultDeleter, CounterType> cache;
+	int created = 0;
+	auto factory = [&](const std::string& path){
+		return [&created, path](){
+			++created;
+			return agm::makeShared<Asset, CounterType>(path);
+		};
+	};
+
+	AssetPtr first = cache.getOrCreate("a", factory("a"));
+	AssetPtr again = cache.getOrCreate("a", factory("a"));
+	CHECK(created == 1);
+	CHECK(again.get() == first.get());
+	CHECK(cache.find("a").get() == first.get());
+	CHECK(!cache.find("b"));
+
+	//The cache doesn't keep objects alive
+	first.reset();
+	again.reset();
+	CHECK(liveCount == 0);
+	CHECK(!cache.find("a"));
+	CHECK(cache.size() == 0);
+
+	AssetPtr recreated = cache.getOrCreate("a", factory("a"));
+	CHECK(created == 2);
+	CHECK(recreated->path == "a");
+
+	//A factory can use the cache itself
+	AssetPtr outer = cache.getOrCreate("outer", [&](){
+		AssetPtr inner = cache.getOrCreate("inner", factory("inner"));
+		return agm::makeShared<Asset, CounterType>("outer");
+	});
+	CHECK(outer->path == "outer");
+	CHECK(!cache.find("inner"));
+}
+
+template<typename CounterType>
+static void testInsertEraseAndGrow(){
+	typedef agm::SharedPtr<Asset, agm::DefaultDeleter, CounterType> AssetPtr;
+
+	agm::WeakCache<int, Asset, agm::DefaultDeleter, CounterType> cache;
+	std::map<int, AssetPtr> alive;
+	for(int i = 0; i < 100; ++i){
+		AssetPtr asset = agm::makeShared<Asset, CounterType>(std::to_string(i));
+		cache.insert(i, asset);
+		//Keep every other one
+		if(i % 2 == 0){
+			alive[i] = asset;
+		}
+	}
+	CHECK(cache.getCapacity() >= 64);
+	CHECK(liveCount == 50);
+
+	for(int i = 0; i < 100; ++i){
+		CHECK(cache.find(i).get() == (i % 2 == 0 ? alive[i].get() : nullptr));
+	}
+	CHECK(cache.size() == 50);
+
+	CHECK(cache.erase(0));
+	CHECK(!cache.erase(0));
+	CHECK(!cache.find(0));
+	CHECK(alive[0]);
+
+	//Inserting an existing key replaces the object
+	AssetPtr replacement = agm::makeShared<Asset, CounterType>("replacement");
+	cache.insert(2, replacement);
+	CHECK(cache.find(2).get() == replacement.get());
+
+	alive.clear();
+	replacement.reset();
+	CHECK(cache.purge() == 49);
+	CHECK(cache.size() == 0);
+
+	cache.insert(1, agm::makeShared<Asset, CounterType>("gone"));
+	cache.clear();
+	CHECK(!cache.find(1));
+}
+
+template<typename CounterType>
+static void testCollisions(){
+	typedef agm::SharedPtr<Asset, agm::DefaultDeleter, CounterType> AssetPtr;
+
+	agm::WeakCache<int, Asset, agm::DefaultDeleter, CounterType, CollidingHash> cache;
+	AssetPtr first = agm::makeShared<Asset, CounterType>("first");
+	AssetPtr second = agm::makeShared<Asset, CounterType>("second");
+	AssetPtr third = agm::makeShared<Asset, CounterType>("third");
+	cache.insert(1, first);
+	cache.insert(2, second);
+	cache.insert(3, third);
+
+	//Purging the middle of a probe chain mustn't hide the entries after it
+	second.reset();
+	CHECK(!cache.find(2));
+	CHECK(cache.find(3).get() == third.get());
+	CHECK(cache.find(1).get() == first.get());
+
+	AssetPtr fourth = agm::makeShared<Asset, CounterType>("fourth");
+	cache.insert(4, fourth);
+	CHECK(cache.find(4).get() == fourth.get());
+	CHECK(cache.size() == 3);
+}
+
+template<typename CounterType>
+static void testOwnerComparison(){
+	typedef agm::SharedPtr<Pair, agm::DefaultDeleter, CounterType> PairPtr;
+	typedef agm::WeakPtr<Pair, agm::DefaultDeleter, CounterType> WeakPair;
+
+	PairPtr owner = agm::makeShared<Pair, CounterType>();
+	PairPtr other = agm::makeShared<Pair, CounterType>();
+	agm::SharedPtr<int, agm::DefaultDeleter, CounterType> aliased(owner, &owner->second);
+
+	//Aliased pointers share an owner
+	CHECK(aliased.ownerEquals(owner));
+	CHECK(!other.ownerEquals(owner));
+	CHECK(aliased.ownerHash() == owner.ownerHash());
+	CHECK(agm::OwnerEqual()(aliased, owner));
+	CHECK(agm::OwnerHash()(aliased) == agm::OwnerHash()(owner));
+	CHECK(owner.ownerBefore(other) != other.ownerBefore(owner));
+	CHECK(!owner.ownerBefore(aliased) && !aliased.ownerBefore(owner));
+
+	//SharedPtr hashes by object, a WeakPtr goes by owner so it keeps its hash after expiring
+	CHECK(std::hash<PairPtr>()(owner) == std::hash<Pair*>()(owner.get()));
+
+	WeakPair weak = owner;
+	const std::size_t weakHash = agm::OwnerHash()(weak);
+
+	std::map<WeakPair, int, agm::OwnerLess> ordered;
+	std::unordered_map<WeakPair, int, agm::OwnerHash, agm::OwnerEqual> unordered;
+	ordered[weak] = 1;
+	unordered[weak] = 1;
+	ordered[other] = 2;
+	unordered[other] = 2;
+
+	owner.reset();
+	aliased.reset();
+	CHECK(agm::OwnerHash()(weak) == weakHash);
+	CHECK(ordered.at(weak) == 1);
+	CHECK(unordered.at(weak) == 1);
+	CHECK(unordered.at(other) == 2);
+
+	//Copies made after expiring still have the owner, so they find the same entries
+	WeakPair expiredCopy = weak;
+	WeakPair expiredAssigned;
+	expiredAssigned = weak;
+	CHECK(!expiredCopy.pin());
+	CHECK(expiredCopy.ownerEquals(weak));
+	CHECK(expiredAssigned.ownerEquals(weak));
+	CHECK(agm::OwnerHash()(expiredCopy) == weakHash);
+	CHECK(ordered.at(expiredCopy) == 1);
+	CHECK(unordered.at(expiredAssigned) == 1);
+
+	std::unordered_set<PairPtr> set;
+	set.insert(other);
+	CHECK(set.count(other) == 1);
+}
+
+template<typename CounterType>
+static void testCounter(){
+	testFindAndCreate<CounterType>();
+	CHECK(liveCount == 0);
+	testInsertEraseAndGrow<CounterType>();
+	CHECK(liveCount == 0);
+	testCollisions<CounterType>();
+	CHECK(liveCount == 0);
+	testOwnerComparison<CounterType>();
+}
+
+int main(){
+	//The strong only counters have no weak count, so they can't be used with a WeakCache
+	testCounter<agm::Counter>();
+	testCounter<agm::AtomicCounter>();
+	testCounter<agm::BiasedCounter>();
+
+	return test::result();
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Ptr.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace agm{
+inline namespace AGM_ABI_NAMESPACE{
+	/////////WEAK CACHE
+	//Maps keys to objects without keeping them alive, e.g. to share one copy of each loaded asset for as long as
+	//something is using it. Entries live in one flat array probed linearly, and an entry whose object has been
+	//released is purged when a lookup passes over it, so the cache never needs a separate sweep. Not thread safe
+	template<typename KeyType, typename Type, typename DeleterType = DefaultDeleter, typename CounterType = DefaultCounter,
+		typename HashType = std::hash<KeyType>, typename KeyEqualType = std::equal_to<KeyType>>
+	class WeakCache{
+		//VARIABLES
+	private:
+		enum class State : std::uint8_t{
+			Empty,
+			Full,
+			Purged,
+		};
+
+		struct Slot{
+			union{
+				KeyType key;
+			};
+			WeakPtr<Type, DeleterType, CounterType> value;
+			std::size_t hash = 0;
+			State state = State::Empty;
+
+			Slot(){}
+			~Slot(){}
+		};
+
+		static constexpr std::size_t minCapacity = 8;
+		static constexpr std::size_t noSlot = ~std::size_t(0);
+
+		Slot* slots = nullptr;
+		std::size_t capacity = 0;
+		int shift = 0;
+
+		//Full entries, including expired ones that haven't been passed over yet
+		std::size_t count = 0;
+		std::size_t purged = 0;
+
+		HashType hasher;
+		KeyEqualType keyEqual;
+
+		//FUNCTIONS
+	public:
+		explicit WeakCache(std::size_t inCapacity = minCapacity);
+
+		WeakCache(const WeakCache& other) = delete;
+
+		~WeakCache();
+
+		WeakCache& operator =(const WeakCache& other) = delete;
+
+		//Returns the cached object, or an empty pointer if there isn't one
+		SharedPtr<Type, DeleterType, CounterType> find(const KeyType& key);
+
+		//Returns the cached object if it's still alive, otherwise caches and returns the result of factory().
+		//The factory is allowed to use the cache itself
+		template<typename FactoryType>
+		SharedPtr<Type, DeleterType, CounterType> getOrCreate(const KeyType& key, FactoryType&& factory);
+
+		void insert(const KeyType& key, const SharedPtr<Type, DeleterType, CounterType>& value);
+		bool erase(const KeyType& key);
+
+		//Removes every expired entry and returns how many there were
+		std::size_t purge();
+		void clear();
+
+		std::size_t size() const;
+		std::size_t getCapacity() const;
+
+	private:
+		//Returns the slot holding key, or noSlot. insertAt is set to the first slot key could be inserted into
+		std::size_t probe(const KeyType& key, std::size_t hash, std::size_t& insertAt);
+
+		std::size_t home(std::size_t hash) const;
+
+		void allocate(std::size_t inCapacity);
+		void rehash(std::size_t inCapacity);
+
+		void purgeSlot(Slot& slot);
+	};
+}
+}
+
+/////////INLINE INCLUDE
+#include "WeakCache.inl"
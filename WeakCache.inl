@@ -0,0 +1,203 @@
+#include <new>
+#include <utility>
+
+/////////WEAK CACHE
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::WeakCache(std::size_t inCapacity){
+	allocate(inCapacity);
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::~WeakCache(){
+	clear();
+	delete[] slots;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline agm::SharedPtr<Type, DeleterType, CounterType> agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::find(const KeyType& key){
+	std::size_t insertAt;
+	const std::size_t index = probe(key, hasher(key), insertAt);
+	if(index == noSlot){
+		return SharedPtr<Type, DeleterType, CounterType>();
+	}
+	return slots[index].value.pin();
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+template<typename FactoryType>
+inline agm::SharedPtr<Type, DeleterType, CounterType> agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::getOrCreate(const KeyType& key, FactoryType&& factory){
+	SharedPtr<Type, DeleterType, CounterType> value = find(key);
+	if(!value){
+		//The factory may have used the cache, so the slot is looked up again rather than remembered
+		value = factory();
+		if(value){
+			insert(key, value);
+		}
+	}
+	return value;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline void agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::insert(const KeyType& key, const agm::SharedPtr<Type, DeleterType, CounterType>& value){
+	//Keep at most 3/4 of the slots in use so every probe reaches an empty slot quickly
+	if((count + purged + 1) * 4 > capacity * 3){
+		rehash((count + 1) * 2 > capacity ? capacity * 2 : capacity);
+	}
+
+	const std::size_t hash = hasher(key);
+	std::size_t insertAt;
+	const std::size_t index = probe(key, hash, insertAt);
+	if(index != noSlot){
+		slots[index].value = value;
+		return;
+	}
+
+	Slot& slot = slots[insertAt];
+	new(&slot.key) KeyType(key);
+	if(slot.state == State::Purged){
+		--purged;
+	}
+	slot.value = value;
+	slot.hash = hash;
+	slot.state = State::Full;
+	++count;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline bool agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::erase(const KeyType& key){
+	std::size_t insertAt;
+	const std::size_t index = probe(key, hasher(key), insertAt);
+	if(index == noSlot){
+		return false;
+	}
+	purgeSlot(slots[index]);
+	return true;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline std::size_t agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::purge(){
+	//Rehashing only keeps live entries, and clears out the purged slots as well
+	const std::size_t before = count;
+	rehash(capacity);
+	return before - count;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline void agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::clear(){
+	for(std::size_t i = 0; i < capacity; ++i){
+		Slot& slot = slots[i];
+		if(slot.state == State::Full){
+			slot.key.~KeyType();
+			slot.value.reset();
+		}
+		slot.state = State::Empty;
+	}
+	count = 0;
+	purged = 0;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline std::size_t agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::size() const{
+	return count;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline std::size_t agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::getCapacity() const{
+	return capacity;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline std::size_t agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::probe(const KeyType& key, std::size_t hash, std::size_t& insertAt){
+	insertAt = noSlot;
+
+	const std::size_t mask = capacity - 1;
+	for(std::size_t i = 0, index = home(hash); i < capacity; ++i, index = (index + 1) & mask){
+		Slot& slot = slots[index];
+
+		if(slot.state == State::Full && !slot.value.isValid()){
+			purgeSlot(slot);
+		}
+
+		switch(slot.state){
+			case State::Empty:
+				if(insertAt == noSlot){
+					insertAt = index;
+				}
+				return noSlot;
+
+			case State::Purged:
+				if(insertAt == noSlot){
+					insertAt = index;
+				}
+				break;
+
+			case State::Full:
+				if(slot.hash == hash && keyEqual(slot.key, key)){
+					return index;
+				}
+				break;
+		}
+	}
+	return noSlot;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline std::size_t agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::home(std::size_t hash) const{
+	//Fibonacci hashing, spreads out hashes like std::hash<int> that are only the key itself
+	return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline void agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::allocate(std::size_t inCapacity){
+	capacity = minCapacity;
+	shift = 64 - 3;
+	while(capacity < inCapacity){
+		capacity *= 2;
+		--shift;
+	}
+	slots = new Slot[capacity];
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline void agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::rehash(std::size_t inCapacity){
+	Slot* oldSlots = slots;
+	const std::size_t oldCapacity = capacity;
+
+	allocate(inCapacity);
+	count = 0;
+	purged = 0;
+
+	const std::size_t mask = capacity - 1;
+	for(std::size_t i = 0; i < oldCapacity; ++i){
+		Slot& oldSlot = oldSlots[i];
+		if(oldSlot.state != State::Full){
+			continue;
+		}
+
+		if(oldSlot.value.isValid()){
+			//Keys are already unique, so each entry goes in the first empty slot
+			std::size_t index = home(oldSlot.hash);
+			while(slots[index].state != State::Empty){
+				index = (index + 1) & mask;
+			}
+
+			Slot& slot = slots[index];
+			new(&slot.key) KeyType(std::move(oldSlot.key));
+			slot.value = std::move(oldSlot.value);
+			slot.hash = oldSlot.hash;
+			slot.state = State::Full;
+			++count;
+		}
+		oldSlot.key.~KeyType();
+	}
+	delete[] oldSlots;
+}
+
+template<typename KeyType, typename Type, typename DeleterType, typename CounterType, typename HashType, typename KeyEqualType>
+inline void agm::WeakCache<KeyType, Type, DeleterType, CounterType, HashType, KeyEqualType>::purgeSlot(Slot& slot){
+	slot.key.~KeyType();
+	slot.value.reset();
+	slot.state = State::Purged;
+	--count;
+	++purged;
+}